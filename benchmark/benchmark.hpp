@@ -0,0 +1,332 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * A small harness for the benchmarks in this directory.
+ *
+ * Every benchmark is calibrated to a number of operations which takes
+ * about --min-ms milliseconds (a repetition), runs --warmup repetitions
+ * which are thrown away and then --reps measured ones. The reported
+ * ns/op is the median of the repetitions, the spread is the median
+ * absolute deviation relative to it.
+ *
+ * Common arguments:
+ *  --filter <s>   only the benchmarks whose name contains s
+ *  --reps <n>     measured repetitions (default 15)
+ *  --warmup <n>   warmup repetitions (default 3)
+ *  --min-ms <ms>  minimum time of a repetition (default 20)
+ *  --out <file>   also write the results as tab separated values
+ *  --baseline <file> --tolerance <%>
+ *                 compare the results with a file written by --out and
+ *                 fail if one of them got slower (default tolerance 10%)
+ */
+namespace bench
+{
+
+/**
+ * @brief DoNotOptimize Keeps the compiler from removing the
+ * computation of the value
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Options
+{
+    std::string filter;
+    int repetitions = 15;
+    int warmup = 3;
+    double minRepMillis = 20.0;
+    std::string out;
+    std::string baseline;
+    double tolerancePercent = 10.0;
+    // the arguments the harness didn't recognize, for the benchmark
+    std::vector<std::string> rest;
+};
+
+inline Options ParseOptions(int argc, char** argv)
+{
+    Options o;
+    for(int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if(hasValue && std::strcmp(argv[i], "--filter") == 0)
+            o.filter = argv[++i];
+        else if(hasValue && std::strcmp(argv[i], "--reps") == 0)
+            o.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if(hasValue && std::strcmp(argv[i], "--warmup") == 0)
+            o.warmup = std::max(0, std::atoi(argv[++i]));
+        else if(hasValue && std::strcmp(argv[i], "--min-ms") == 0)
+            o.minRepMillis = std::max(0.1, std::atof(argv[++i]));
+        else if(hasValue && std::strcmp(argv[i], "--out") == 0)
+            o.out = argv[++i];
+        else if(hasValue && std::strcmp(argv[i], "--baseline") == 0)
+            o.baseline = argv[++i];
+        else if(hasValue && std::strcmp(argv[i], "--tolerance") == 0)
+            o.tolerancePercent = std::max(0.0, std::atof(argv[++i]));
+        else
+            o.rest.push_back(argv[i]);
+    }
+    return o;
+}
+
+struct Result
+{
+    std::string name;
+    double nsPerOp;      // median of the repetitions
+    double minNsPerOp;   // fastest repetition
+    double relMad;       // median absolute deviation / median
+    int64_t opsPerRep;
+    int repetitions;
+
+    double OpsPerSecond() const
+    {
+        return nsPerOp > 0 ? 1e9 / nsPerOp : 0.0;
+    }
+};
+
+inline double Median(std::vector<double> v)
+{
+    if(v.empty())
+        return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+/**
+ * @brief Percentile The nearest-rank percentile p (0-100) of the values
+ */
+inline double Percentile(std::vector<double> v, double p)
+{
+    if(v.empty())
+        return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t rank = (size_t)std::ceil(p / 100.0 * v.size());
+    return v[std::min(v.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+/**
+ * @brief ReadResults Reads a file written by --out, false if it can't
+ * be opened
+ */
+inline bool ReadResults(const std::string& path, std::vector<Result>& results)
+{
+    std::ifstream in(path);
+    if(!in)
+        return false;
+    results.clear();
+    std::string line;
+    while(std::getline(in, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        Result r;
+        double opsPerSecond;
+        if(std::getline(fields, r.name, '\t') && fields >> r.nsPerOp >> opsPerSecond >> r.minNsPerOp >> r.relMad
+                >> r.opsPerRep >> r.repetitions)
+            results.push_back(r);
+    }
+    return true;
+}
+
+/**
+ * @brief CompareWithBaseline Prints how every result compares with the
+ * baseline. A result is slower if its median is above the baseline by
+ * more than the tolerance, or three times the spread of the two if that
+ * is more (noisy results don't fail). Returns false if one is slower.
+ */
+inline bool CompareWithBaseline(const std::vector<Result>& results, const std::vector<Result>& baseline,
+                                double tolerancePercent, std::ostream& out)
+{
+    int slower = 0, faster = 0, missing = 0;
+    out << std::endl << std::left << std::setw(52) << "compared with the baseline" << std::right << std::setw(14)
+        << "baseline" << std::setw(14) << "now" << std::setw(10) << "change" << std::endl;
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    for(const Result& r : results)
+    {
+        auto b = std::find_if(baseline.begin(), baseline.end(), [&](const Result& x)
+        {
+            return x.name == r.name;
+        });
+        if(b == baseline.end() || b->nsPerOp <= 0)
+        {
+            out << std::left << std::setw(52) << r.name << std::right << std::setw(14) << "-" << std::endl;
+            missing++;
+            continue;
+        }
+        const double change = r.nsPerOp / b->nsPerOp - 1.0;
+        const double threshold = std::max(tolerancePercent / 100.0, 3.0 * std::max(r.relMad, b->relMad));
+        const char* verdict = "";
+        if(change > threshold)
+        {
+            verdict = "  SLOWER";
+            slower++;
+        }
+        else if(change < -threshold)
+        {
+            verdict = "  faster";
+            faster++;
+        }
+        out << std::left << std::setw(52) << r.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << b->nsPerOp << std::setw(14) << r.nsPerOp << std::setw(9) << std::showpos
+            << 100.0 * change << "%" << std::noshowpos << verdict << std::endl;
+        out.flags(flags);
+        out.precision(precision);
+    }
+    out << std::endl << "Verdict: " << (slower ? "SLOWER" : faster ? "faster" : "same") << " (" << slower
+        << " slower, " << faster << " faster, " << missing << " not in the baseline)" << std::endl;
+    return slower == 0;
+}
+
+class Runner
+{
+public:
+    explicit Runner(const Options& options) : options(options) {}
+
+    /**
+     * @brief Run Measures body(n), which has to do n operations. Setup
+     * which isn't part of the operation belongs outside of body or has
+     * to be subtracted by a separate benchmark.
+     */
+    template<typename F>
+    void Run(const std::string& name, F&& body)
+    {
+        if(!options.filter.empty() && name.find(options.filter) == std::string::npos)
+            return;
+
+        // double the operations until a repetition is long enough
+        int64_t ops = 1;
+        double millis = Time(body, ops) * 1e-6;
+        while(millis < options.minRepMillis && ops < (int64_t(1) << 40))
+        {
+            const double factor = millis > 0.01 ? options.minRepMillis / millis * 1.2 : 10.0;
+            ops = std::max(ops + 1, (int64_t)(ops * std::min(factor, 10.0)));
+            millis = Time(body, ops) * 1e-6;
+        }
+
+        for(int i = 0; i < options.warmup; i++)
+            Time(body, ops);
+
+        std::vector<double> nsPerOp(options.repetitions);
+        for(double& ns : nsPerOp)
+            ns = Time(body, ops) / ops;
+
+        Result r;
+        r.name = name;
+        r.nsPerOp = Median(nsPerOp);
+        r.minNsPerOp = *std::min_element(nsPerOp.begin(), nsPerOp.end());
+        std::vector<double> deviations;
+        for(double ns : nsPerOp)
+            deviations.push_back(std::abs(ns - r.nsPerOp));
+        r.relMad = r.nsPerOp > 0 ? Median(deviations) / r.nsPerOp : 0.0;
+        r.opsPerRep = ops;
+        r.repetitions = options.repetitions;
+        Print(r);
+        results.push_back(r);
+    }
+
+    /**
+     * @brief Add Adds a result measured by the benchmark itself (e.g. a
+     * whole game), so that it is written like the others. Benchmarks
+     * with their own table don't print it.
+     */
+    void Add(const Result& r, bool print = true)
+    {
+        if(!options.filter.empty() && r.name.find(options.filter) == std::string::npos)
+            return;
+        if(print)
+            Print(r);
+        results.push_back(r);
+    }
+
+    const std::vector<Result>& Results() const
+    {
+        return results;
+    }
+
+    /**
+     * @brief Finish Writes the results to --out and compares them with
+     * --baseline, false if that failed or something got slower
+     */
+    bool Finish() const
+    {
+        if(!options.out.empty())
+        {
+            std::ofstream out(options.out);
+            out << "# name\tns_per_op\tops_per_sec\tmin_ns_per_op\trel_mad\tops_per_rep\trepetitions\n";
+            out << std::setprecision(10);
+            for(const Result& r : results)
+            {
+                out << r.name << "\t" << r.nsPerOp << "\t" << r.OpsPerSecond() << "\t" << r.minNsPerOp << "\t"
+                    << r.relMad << "\t" << r.opsPerRep << "\t" << r.repetitions << "\n";
+            }
+            if(!out)
+            {
+                std::cerr << "Couldn't write " << options.out << std::endl;
+                return false;
+            }
+        }
+        if(options.baseline.empty())
+            return true;
+
+        std::vector<Result> baseline;
+        if(!ReadResults(options.baseline, baseline))
+        {
+            std::cerr << "Couldn't read the baseline " << options.baseline << std::endl;
+            return false;
+        }
+        return CompareWithBaseline(results, baseline, options.tolerancePercent, std::cout);
+    }
+
+private:
+    template<typename F>
+    static double Time(F& body, int64_t ops)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        body(ops);
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Print(const Result& r)
+    {
+        if(!headerPrinted)
+        {
+            std::cout << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "ns/op"
+                      << std::setw(16) << "ops/sec" << std::setw(10) << "+/-" << std::endl;
+            headerPrinted = true;
+        }
+        const std::ios::fmtflags flags = std::cout.flags();
+        const std::streamsize precision = std::cout.precision();
+        std::cout << std::left << std::setw(36) << r.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << r.nsPerOp << std::setw(16) << std::setprecision(0) << r.OpsPerSecond()
+                  << std::setw(9) << std::setprecision(1) << 100.0 * r.relMad << "%" << std::endl;
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+
+    Options options;
+    std::vector<Result> results;
+    bool headerPrinted = false;
+};
+
+}
+
+#endif // BENCHMARK_H
@@ -0,0 +1,27 @@
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#include <cstdint>
+
+#include "agents.hpp"
+
+/**
+ * The C ABI of the shared library (bboard.cpp), the entry points the
+ * Python agents call through ctypes
+ */
+extern "C"
+{
+void c_init_agent_frankfurt(int id);
+float c_episode_end_frankfurt(int id);
+int c_getStep_frankfurt(int id, bool agent0Alive, bool agent1Alive, bool agent2Alive, bool agent3Alive, uint8_t * board, double * bomb_life, double * bomb_blast_strength, double * bomb_moving_direction, double * flame_life, int posx, int posy, int blast_strength, bool can_kick, int ammo, int game_type, int teammate_id, int message1, int message2);
+void c_getSearchStats_frankfurt(int id, agents::SearchStats * stats);
+
+void c_init_agent_gottingen(int id);
+float c_episode_end_gottingen(int id);
+int c_getStep_gottingen(int id, bool agent0Alive, bool agent1Alive, bool agent2Alive, bool agent3Alive, uint8_t * board, double * bomb_life, double * bomb_blast_strength, double * bomb_moving_direction, double * flame_life, int posx, int posy, int blast_strength, bool can_kick, int ammo, int game_type, int teammate_id, int message1, int message2);
+void c_getSearchStats_gottingen(int id, agents::SearchStats * stats);
+
+void c_setTimeStep(int id, int timeStep);
+}
+
+#endif // BRIDGE_H
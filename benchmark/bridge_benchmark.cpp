@@ -0,0 +1,253 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "bridge.hpp"
+#include "scenario.hpp"
+
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "trace.hpp"
+
+using namespace bboard;
+
+/**
+ * The time of a turn behind the Python bridge, end to end. Recorded
+ * observations (the raw arrays, in the scenario format) are replayed turn
+ * by turn through c_getStep_*, by one agent which keeps what it learned
+ * from the earlier turns, like in a game. The time of every call is split
+ * by the spans of the trace (trace.hpp) into the conversion of the
+ * observation (MakeGameFromPython), the precomputation of the turn
+ * (createDeadEndMap), the search and the rest (the bookkeeping of act).
+ *
+ * The observations are recorded from games of SimpleAgents (--games,
+ * --seed, --max-steps, seen by agent --id); --save writes them in a
+ * directory for each game. --recording replays a directory of *.scn files
+ * instead, in the order of their names.
+ *
+ * Usage: bridge_benchmark [--agent name] [--games n] [--seed s] [--id i]
+ *                         [--max-steps n] [--save dir] [--recording dir]
+ *                         [--filter s] [--out file] [--baseline file]
+ */
+
+struct SearchAgentApi
+{
+    const char* name;
+    decltype(&c_init_agent_gottingen) init;
+    decltype(&c_getStep_gottingen) getStep;
+};
+
+const SearchAgentApi AGENTS[] =
+{
+    {"frankfurt", c_init_agent_frankfurt, c_getStep_frankfurt},
+    {"gottingen", c_init_agent_gottingen, c_getStep_gottingen}
+};
+
+typedef std::vector<bench::Scenario> Recording;
+
+/**
+ * @brief Record The observations of agent `id` in a game of SimpleAgents,
+ * until it dies or the game ends
+ */
+Recording Record(int seed, int maxSteps, int id)
+{
+    agents::SimpleAgent simple[AGENT_COUNT];
+    std::array<Agent*, AGENT_COUNT> players;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        // the same games in every run
+        simple[i].rng.seed(seed * AGENT_COUNT + i);
+        players[i] = &simple[i];
+    }
+
+    Environment env;
+    env.MakeGame(players);
+    State& state = env.GetState();
+    InitBoardItems(state, seed);
+    state.PutAgentsInCorners(0, 1, 2, 3);
+
+    Recording r;
+    while(!env.IsDone() && state.timeStep < maxSteps && !state.agents[id].dead)
+    {
+        bench::Scenario s;
+        bench::Observe(state, id, s);
+        // the first observation of the Python side is turn 1
+        s.timeStep = state.timeStep + 1;
+        char name[16];
+        std::snprintf(name, sizeof(name), "t%04d", s.timeStep);
+        s.name = name;
+        r.push_back(s);
+        env.Step(false);
+    }
+    return r;
+}
+
+struct Turn
+{
+    double total;
+    double conversion;
+    double precompute;
+    double search;
+};
+
+/**
+ * @brief Replay Decides every turn of the recording through the C ABI
+ */
+std::vector<Turn> Replay(const SearchAgentApi& agent, const Recording& recording)
+{
+    std::vector<Turn> turns;
+    if(recording.empty())
+        return turns;
+    const int id = recording[0].id;
+    agent.init(id);
+    c_setTimeStep(id, recording[0].timeStep - 1);
+    // the calibration of the agent searched too
+    for(int i = 0; i < AGENT_COUNT; i++)
+        trace::TakeTotals(i);
+
+    bench::Observation obs;
+    for(const bench::Scenario& s : recording)
+    {
+        obs.CopyFrom(s);
+        const auto start = std::chrono::steady_clock::now();
+        agent.getStep(s.id, s.alive[0], s.alive[1], s.alive[2], s.alive[3], obs.board, obs.bombLife,
+                      obs.bombBlastStrength, obs.bombMovingDirection, obs.flameLife, s.posx, s.posy, s.blastStrength,
+                      s.canKick, s.ammo, s.gameType, s.teammateId, s.message[0], s.message[1]);
+        const double total = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        std::map<std::string, int64_t> spans = trace::TakeTotals(id);
+        turns.push_back({total, (double)spans["MakeGameFromPython"], (double)spans["createDeadEndMap"],
+                         (double)(spans["quick search"] + spans["search"])});
+    }
+    return turns;
+}
+
+bench::Result Summarize(const std::string& name, const std::vector<double>& ns)
+{
+    const double median = bench::Median(ns);
+    std::vector<double> deviations;
+    for(double v : ns)
+        deviations.push_back(std::abs(v - median));
+    return {name, median, bench::Percentile(ns, 0), median > 0 ? bench::Median(deviations) / median : 0.0, 1,
+            (int)ns.size()};
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::ParseOptions(argc, argv);
+    std::string agentName, saveDir, recordingDir;
+    int games = 2, seed = 1, maxSteps = 200, id = 0;
+    for(size_t i = 0; i + 1 < options.rest.size(); i += 2)
+    {
+        if(options.rest[i] == "--agent")
+            agentName = options.rest[i + 1];
+        else if(options.rest[i] == "--games")
+            games = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--seed")
+            seed = std::atoi(options.rest[i + 1].c_str());
+        else if(options.rest[i] == "--max-steps")
+            maxSteps = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--id")
+            id = std::min(3, std::max(0, std::atoi(options.rest[i + 1].c_str())));
+        else if(options.rest[i] == "--save")
+            saveDir = options.rest[i + 1];
+        else if(options.rest[i] == "--recording")
+            recordingDir = options.rest[i + 1];
+    }
+
+    std::vector<Recording> recordings;
+    if(!recordingDir.empty())
+    {
+        Recording r;
+        std::string error;
+        if(!bench::LoadScenarios(recordingDir, r, error) || r.empty())
+        {
+            std::cerr << (error.empty() ? "No observations in " + recordingDir : error) << std::endl;
+            return 1;
+        }
+        recordings.push_back(r);
+    }
+    else
+    {
+        for(int g = 0; g < games; g++)
+            recordings.push_back(Record(seed + g, maxSteps, id));
+    }
+    if(!saveDir.empty())
+    {
+        for(size_t g = 0; g < recordings.size(); g++)
+        {
+            const std::string dir = saveDir + "/game" + std::to_string(g);
+            std::filesystem::create_directories(dir);
+            for(const bench::Scenario& s : recordings[g])
+            {
+                if(!bench::SaveScenario(dir + "/" + s.name + ".scn", s))
+                {
+                    std::cerr << "Couldn't write " << dir << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // the decisions of the agents would be printed, unless they are logged
+    setenv("POMMERMAN_DECISION_LOG", "/dev/null", 0);
+    // the spans are kept in memory, without an episode end they aren't written
+    trace::Configure(1, "bridge_benchmark", true);
+
+    bench::Runner runner(options);
+    std::cout << std::left << std::setw(12) << "agent" << std::right << std::setw(7) << "turns" << std::setw(10)
+              << "p50 ms" << std::setw(10) << "p99 ms" << std::setw(14) << "convert us" << std::setw(14)
+              << "deadends us" << std::setw(11) << "search ms" << std::setw(10) << "rest us" << std::endl;
+    for(const SearchAgentApi& agent : AGENTS)
+    {
+        if(!agentName.empty() && agentName != agent.name)
+            continue;
+        std::vector<double> total, conversion, precompute, search, rest;
+        // the conversion talks about the bombs it sees
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        std::vector<Turn> turns;
+        for(const Recording& r : recordings)
+        {
+            const std::vector<Turn> game = Replay(agent, r);
+            turns.insert(turns.end(), game.begin(), game.end());
+        }
+        std::cout.rdbuf(out);
+        std::cout.clear();
+        for(const Turn& t : turns)
+        {
+            total.push_back(t.total);
+            conversion.push_back(t.conversion);
+            precompute.push_back(t.precompute);
+            search.push_back(t.search);
+            rest.push_back(std::max(0.0, t.total - t.conversion - t.precompute - t.search));
+        }
+        if(total.empty())
+            continue;
+
+        const std::ios::fmtflags flags = std::cout.flags();
+        std::cout << std::left << std::setw(12) << agent.name << std::right << std::setw(7) << total.size()
+                  << std::fixed << std::setprecision(2) << std::setw(10) << bench::Median(total) / 1e6 << std::setw(10)
+                  << bench::Percentile(total, 99) / 1e6 << std::setprecision(1) << std::setw(14)
+                  << bench::Median(conversion) / 1e3 << std::setw(14) << bench::Median(precompute) / 1e3
+                  << std::setprecision(2) << std::setw(11) << bench::Median(search) / 1e6 << std::setprecision(1)
+                  << std::setw(10) << bench::Median(rest) / 1e3 << std::endl;
+        std::cout.flags(flags);
+        std::cout.precision(6);
+
+        const std::string name = std::string("bridge/") + agent.name;
+        runner.Add(Summarize(name + "/turn", total), false);
+        runner.Add(Summarize(name + "/conversion", conversion), false);
+        runner.Add(Summarize(name + "/deadends", precompute), false);
+        runner.Add(Summarize(name + "/search", search), false);
+        runner.Add(Summarize(name + "/rest", rest), false);
+    }
+
+    return runner.Finish() ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#ifndef BRIDGED_AGENT_H
+#define BRIDGED_AGENT_H
+
+#include <array>
+#include <chrono>
+#include <type_traits>
+#include <vector>
+
+#include "scenario.hpp"
+
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "trace.hpp"
+
+namespace bench
+{
+
+/**
+ * @brief Bridged An agent which plays through the observations of the
+ * Python environment, and talks to its teammate with messages
+ */
+struct Bridged : bboard::Agent
+{
+    // the message of the teammate in the last step
+    int received[2] = {-1, -1};
+
+    virtual const int* Sent() const = 0;
+};
+
+/**
+ * @brief BridgedAgent A search agent behind the Python bridge. Every turn
+ * it gets the observation of the Python environment (Observe) through
+ * MakeGameFromPython_*, with its own Environment like in bboard.cpp, so
+ * it runs the same code as behind c_getStep_*. The board is fully visible.
+ */
+template<typename A>
+struct BridgedAgent : Bridged
+{
+    explicit BridgedAgent(int id)
+    {
+        this->id = id;
+        view.MakeGameFromPython(id);
+    }
+
+    bboard::Move act(const bboard::State* state) override
+    {
+        Observe(*state, id, obs);
+        obs.message[0] = received[0];
+        obs.message[1] = received[1];
+
+        agent.start_time = std::chrono::high_resolution_clock::now();
+        bboard::trace::SetAgent(id);
+        Convert(obs, view, std::is_same<A, agents::FrankfurtAgent>::value);
+        agent.id = view.GetState().ourId;
+        const bboard::Move m = agent.act(&view.GetState());
+        turnMillis.push_back(std::chrono::duration<double, std::milli>(
+                                 std::chrono::high_resolution_clock::now() - agent.start_time).count());
+        return m;
+    }
+
+    const int* Sent() const override
+    {
+        return agent.message;
+    }
+
+    A agent;
+    bboard::Environment view;
+    Scenario obs;
+    std::vector<double> turnMillis;
+};
+
+/**
+ * @brief ForwardMessages Passes the messages of the last step between the
+ * bridged teammates, they arrive with the next observation
+ */
+inline void ForwardMessages(const std::array<bboard::Agent*, bboard::AGENT_COUNT>& players)
+{
+    for(int i = 0; i < bboard::AGENT_COUNT; i++)
+    {
+        Bridged* me = dynamic_cast<Bridged*>(players[i]);
+        const Bridged* teammate = dynamic_cast<const Bridged*>(players[(i + 2) % bboard::AGENT_COUNT]);
+        if(me && teammate)
+        {
+            me->received[0] = teammate->Sent()[0];
+            me->received[1] = teammate->Sent()[1];
+        }
+    }
+}
+
+}
+
+#endif // BRIDGED_AGENT_H
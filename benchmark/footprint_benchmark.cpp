@@ -0,0 +1,305 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <pthread.h>
+
+#include "benchmark.hpp"
+#include "scenario.hpp"
+
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+/**
+ * The memory footprint of the search. Prints the layout of the structures
+ * of the hot path (sizes, offsets and padding) and measures on the
+ * scenario corpus how many bytes of State the search copies per simulated
+ * step (every step of runOneStep copies the State, also the ones which
+ * fail) and how deep the stack of act gets with the runOneStep recursion.
+ * The searches run on one thread without the turn deadline, so the
+ * numbers only change with the code.
+ *
+ * The results are bytes, not times, so that --out and --baseline track
+ * them like the other benchmarks (a bigger footprint is "slower").
+ *
+ * Usage: footprint_benchmark [--corpus dir] [--agent name] [--filter s]
+ *                            [--out file] [--baseline file]
+ */
+
+/**
+ * @brief Layout Prints a structure and its fields
+ */
+class Layout
+{
+public:
+    Layout(const char* name, size_t size, size_t align) : size(size)
+    {
+        std::cout << std::endl << name << ": " << size << " bytes, align " << align << ", "
+                  << (size + 63) / 64 << " cache lines" << std::endl;
+    }
+
+    void Field(const char* name, size_t offset, size_t fieldSize)
+    {
+        if(offset > end)
+            std::cout << "  " << std::setw(6) << end << std::setw(8) << offset - end << "  (padding)" << std::endl;
+        std::cout << "  " << std::setw(6) << offset << std::setw(8) << fieldSize << "  " << name << std::endl;
+        end = offset + fieldSize;
+    }
+
+    ~Layout()
+    {
+        if(size > end)
+            std::cout << "  " << std::setw(6) << end << std::setw(8) << size - end << "  (padding)" << std::endl;
+    }
+
+private:
+    size_t size;
+    size_t end = 0;
+};
+
+#define LAYOUT(T) Layout layout(#T, sizeof(T), alignof(T))
+#define LAYOUT_NAMED(T, name) Layout layout(name, sizeof(T), alignof(T))
+#define FIELD(T, f) layout.Field(#f, offsetof(T, f), sizeof(T::f))
+
+template<typename T, int TSize>
+void PrintQueue(const std::string& name)
+{
+    typedef FixedQueue<T, TSize> Q;
+    LAYOUT_NAMED(Q, name.c_str());
+    FIELD(Q, queue);
+    FIELD(Q, index);
+    FIELD(Q, count);
+}
+
+void PrintLayouts()
+{
+    std::cout << "Build:";
+#ifdef NDEBUG
+    std::cout << " NDEBUG";
+#endif
+#ifdef _GLIBCXX_ASSERTIONS
+    std::cout << " _GLIBCXX_ASSERTIONS";
+#endif
+#ifdef STEP_PROFILE
+    std::cout << " STEP_PROFILE";
+#endif
+#ifdef VERBOSE_STATE
+    std::cout << " VERBOSE_STATE";
+#endif
+#ifdef _OPENMP
+    std::cout << " OpenMP";
+#endif
+    std::cout << " (the layouts don't depend on the build flags)" << std::endl;
+    std::cout << "sizeof(StepResult) " << sizeof(agents::StepResult) << ", sizeof(Bomb) " << sizeof(Bomb)
+              << ", sizeof(Position) " << sizeof(Position) << ", sizeof(Flame) " << sizeof(Flame) << std::endl;
+    {
+        LAYOUT(State);
+        FIELD(State, board);
+        FIELD(State, relTimeStep);
+        FIELD(State, aliveAgents);
+        FIELD(State, longestChainedBombDistance);
+        FIELD(State, timeStep);
+        FIELD(State, ourId);
+        FIELD(State, teammateId);
+        FIELD(State, enemy1Id);
+        FIELD(State, enemy2Id);
+        FIELD(State, comeAround);
+        FIELD(State, agents);
+        FIELD(State, bombs);
+        FIELD(State, flames);
+        FIELD(State, woods);
+        FIELD(State, powerup_incr);
+        FIELD(State, powerup_kick);
+        FIELD(State, powerup_extrabomb);
+    }
+    {
+        LAYOUT(AgentInfo);
+        FIELD(AgentInfo, x);
+        FIELD(AgentInfo, y);
+        FIELD(AgentInfo, bombCount);
+        FIELD(AgentInfo, maxBombCount);
+        FIELD(AgentInfo, bombStrength);
+        FIELD(AgentInfo, canKick);
+        FIELD(AgentInfo, dead);
+        FIELD(AgentInfo, diedAt);
+        FIELD(AgentInfo, extraBombPowerupPoints);
+        FIELD(AgentInfo, extraRangePowerupPoints);
+        FIELD(AgentInfo, otherKickPowerupPoints);
+        FIELD(AgentInfo, firstKickPowerupPoints);
+        FIELD(AgentInfo, woodDemolished);
+        FIELD(AgentInfo, starts_on_bomb);
+    }
+    PrintQueue<Bomb, MAX_BOMBS>("FixedQueue<Bomb, " + std::to_string(MAX_BOMBS) + "> (State::bombs)");
+    PrintQueue<Flame, MAX_BOMBS>("FixedQueue<Flame, " + std::to_string(MAX_BOMBS) + "> (State::flames)");
+    PrintQueue<Position, 25>("FixedQueue<Position, 25> (State::woods)");
+    PrintQueue<Position, 5>("FixedQueue<Position, 5> (State::powerup_*)");
+    PrintQueue<int, 40>("FixedQueue<int, 40> (SearchAgent::moves_in_chain)");
+    PrintQueue<Position, 40>("FixedQueue<Position, 40> (SearchAgent::positions_in_chain)");
+    std::cout << std::endl << "sizeof(FrankfurtAgent) " << sizeof(agents::FrankfurtAgent) << ", sizeof(GottingenAgent) "
+              << sizeof(agents::GottingenAgent) << ", sizeof(PVTable) " << sizeof(agents::PVTable) << std::endl;
+}
+
+const unsigned char PAINT = 0xA5;
+
+void* RunFunction(void* f)
+{
+    (*static_cast<std::function<void()>*>(f))();
+    return nullptr;
+}
+
+/**
+ * @brief PeakStack Runs f on a thread with a painted stack and returns
+ * the bytes of the stack which f touched
+ */
+size_t PeakStack(std::function<void()> f)
+{
+    const size_t size = 8 << 20;
+    unsigned char* stack = static_cast<unsigned char*>(std::aligned_alloc(4096, size));
+    std::memset(stack, PAINT, size);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, size);
+    pthread_t thread;
+    if(pthread_create(&thread, &attr, RunFunction, &f) != 0)
+    {
+        std::cerr << "Couldn't start the thread" << std::endl;
+        std::exit(1);
+    }
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+
+    // the stack grows down
+    size_t untouched = 0;
+    while(untouched < size && stack[untouched] == PAINT)
+        untouched++;
+    std::free(stack);
+    return size - untouched;
+}
+
+struct Footprint
+{
+    int depth = 0;
+    int64_t nodes = 0;
+    int64_t copies = 0;
+    size_t stackBytes = 0;
+};
+
+template<typename A>
+Footprint Measure(const bench::Scenario& s)
+{
+    Footprint r;
+    r.stackBytes = PeakStack([&]
+    {
+        Environment view;
+        view.MakeGameFromPython(s.id);
+        view.GetState().timeStep = s.timeStep - 1;
+        bench::Convert(s, view, std::is_same<A, agents::FrankfurtAgent>::value);
+
+        auto agent = std::make_unique<A>();
+        agent->id = view.GetState().ourId;
+        agent->verbose = false;
+        agent->useKillSolver = false;
+        agent->rootThreads = 1;
+        agent->timeLimit = false;
+        agent->start_time = std::chrono::high_resolution_clock::now();
+        agent->act(&view.GetState());
+
+        r.depth = agent->myMaxDepth;
+        r.nodes = agent->stats.TotalNodes();
+        r.copies = r.nodes + agent->stats.cutoffs[agents::SearchStats::STEP_FAILED];
+    });
+    return r;
+}
+
+template<typename A>
+void Benchmark(const std::string& name, const std::vector<bench::Scenario>& scenarios, bench::Runner& runner)
+{
+    int64_t nodes = 0, copies = 0;
+    size_t peakStack = 0;
+    int peakDepth = 0;
+    // the smallest stack of the searches of each depth
+    std::map<int, size_t> stackOfDepth;
+    for(const bench::Scenario& s : scenarios)
+    {
+        const Footprint f = Measure<A>(s);
+        nodes += f.nodes;
+        copies += f.copies;
+        if(f.nodes > 0 && (!stackOfDepth.count(f.depth) || f.stackBytes < stackOfDepth[f.depth]))
+            stackOfDepth[f.depth] = f.stackBytes;
+        if(f.stackBytes > peakStack)
+        {
+            peakStack = f.stackBytes;
+            peakDepth = f.depth;
+        }
+        std::cout << std::left << std::setw(36) << name + "/" + s.name << std::right << std::setw(7) << f.depth
+                  << std::setw(10) << f.nodes << std::setw(14)
+                  << (f.nodes ? f.copies * sizeof(State) / f.nodes : 0) << std::setw(14) << f.stackBytes << std::endl;
+    }
+    if(nodes == 0)
+        return;
+
+    const double bytesPerNode = (double)copies * sizeof(State) / nodes;
+    std::cout << std::left << std::setw(36) << name << std::right << std::setw(7) << peakDepth << std::setw(10) << nodes
+              << std::setw(14) << (int64_t)bytesPerNode << std::setw(14) << peakStack << std::endl;
+    runner.Add({"footprint/" + name + "/state_bytes_per_node", bytesPerNode, bytesPerNode, 0.0, nodes, 1}, false);
+    runner.Add({"footprint/" + name + "/peak_stack_bytes", (double)peakStack, (double)peakStack, 0.0, 1, 1}, false);
+
+    // a level of the recursion is the difference of the searches one level deeper
+    if(stackOfDepth.size() > 1)
+    {
+        const auto shallow = stackOfDepth.begin(), deep = std::prev(stackOfDepth.end());
+        const double perLevel = ((double)deep->second - shallow->second) / (deep->first - shallow->first);
+        std::cout << "  runOneStep: " << (int64_t)perLevel << " bytes of stack per level (depth " << shallow->first
+                  << " to " << deep->first << ")" << std::endl;
+        runner.Add({"footprint/" + name + "/stack_bytes_per_level", perLevel, perLevel, 0.0, 1, 1}, false);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::ParseOptions(argc, argv);
+    std::string corpus = "benchmark/scenarios";
+    std::string agentName;
+    for(size_t i = 0; i + 1 < options.rest.size(); i += 2)
+    {
+        if(options.rest[i] == "--corpus")
+            corpus = options.rest[i + 1];
+        else if(options.rest[i] == "--agent")
+            agentName = options.rest[i + 1];
+    }
+
+    std::vector<bench::Scenario> scenarios;
+    std::string error;
+    if(!bench::LoadScenarios(corpus, scenarios, error) || scenarios.empty())
+    {
+        std::cerr << (error.empty() ? "No scenarios in " + corpus : error) << std::endl;
+        return 1;
+    }
+
+    PrintLayouts();
+    agents::GottingenAgent::Calibrate();
+
+    bench::Runner runner(options);
+    runner.Add({"footprint/state_bytes", (double)sizeof(State), (double)sizeof(State), 0.0, 1, 1}, false);
+    std::cout << std::endl << std::left << std::setw(36) << "search" << std::right << std::setw(7) << "depth"
+              << std::setw(10) << "nodes" << std::setw(14) << "bytes/node" << std::setw(14) << "stack bytes" << std::endl;
+    if(agentName.empty() || agentName == "frankfurt")
+        Benchmark<agents::FrankfurtAgent>("frankfurt", scenarios, runner);
+    if(agentName.empty() || agentName == "gottingen")
+        Benchmark<agents::GottingenAgent>("gottingen", scenarios, runner);
+
+    return runner.Finish() ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "bridged_agent.hpp"
+
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+/**
+ * How many games per second we can play to evaluate agents. Whole games
+ * of a mix of agents (--agents, the agents of the slots 0-3) are played
+ * headless with Environment::StartGame (no rendering, no pauses, no time
+ * limit), first on one thread and then with a game on every core
+ * (--threads picks one of them). The boards and the random agents are
+ * seeded by the game. The search agents keep the deadline of their turns,
+ * so their games depend on the machine and its load.
+ *
+ * The agents are simple, random, harmless, lazy, frankfurt and gottingen.
+ * The search agents play through the bridge (bench::BridgedAgent); with
+ * more than one game at a time they search on one thread, without the
+ * kill solver. The games end by the rules of StartGame: when at most one
+ * agent is alive or after --max-steps.
+ *
+ * Usage: game_benchmark [--agents a,b,c,d] [--games n] [--seed s]
+ *                       [--max-steps n] [--threads n] [--filter s]
+ *                       [--out file] [--baseline file]
+ */
+
+/**
+ * @brief MakeAgent The agent of a slot, nullptr if there is no such agent
+ */
+std::unique_ptr<Agent> MakeAgent(const std::string& name, int id, int seed, bool parallel)
+{
+    std::unique_ptr<Agent> agent;
+    if(name == "simple")
+    {
+        auto a = std::make_unique<agents::SimpleAgent>();
+        a->rng.seed(seed * AGENT_COUNT + id);
+        agent = std::move(a);
+    }
+    else if(name == "random")
+    {
+        auto a = std::make_unique<agents::RandomAgent>();
+        a->rng.seed(seed * AGENT_COUNT + id);
+        agent = std::move(a);
+    }
+    else if(name == "harmless")
+    {
+        auto a = std::make_unique<agents::HarmlessAgent>();
+        a->rng.seed(seed * AGENT_COUNT + id);
+        agent = std::move(a);
+    }
+    else if(name == "lazy")
+    {
+        agent = std::make_unique<agents::LazyAgent>();
+    }
+    else if(name == "frankfurt" || name == "gottingen")
+    {
+        auto configure = [parallel](auto& searcher)
+        {
+            if(parallel)
+            {
+                searcher.rootThreads = 1;
+                searcher.useKillSolver = false;
+            }
+        };
+        if(name == "frankfurt")
+        {
+            auto a = std::make_unique<bench::BridgedAgent<agents::FrankfurtAgent>>(id);
+            configure(a->agent);
+            agent = std::move(a);
+        }
+        else
+        {
+            auto a = std::make_unique<bench::BridgedAgent<agents::GottingenAgent>>(id);
+            configure(a->agent);
+            agent = std::move(a);
+        }
+    }
+    if(agent)
+        agent->id = id;
+    return agent;
+}
+
+struct GameResult
+{
+    int steps = 0;
+    // the agent which won, -1 for a draw or an unfinished game
+    int winner = -1;
+};
+
+GameResult PlayGame(const std::vector<std::string>& mix, int seed, int maxSteps, bool parallel)
+{
+    std::unique_ptr<Agent> owned[AGENT_COUNT];
+    std::array<Agent*, AGENT_COUNT> players;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        owned[i] = MakeAgent(mix[i], i, seed, parallel);
+        players[i] = owned[i].get();
+    }
+
+    Environment env;
+    env.MakeGame(players);
+    State& state = env.GetState();
+    InitBoardItems(state, seed);
+    state.PutAgentsInCorners(0, 1, 2, 3);
+    env.SetStepListener([&](const Environment&)
+    {
+        bench::ForwardMessages(players);
+    });
+    env.StartGame(maxSteps, false);
+
+    GameResult r;
+    r.steps = state.timeStep;
+    if(env.IsDone() && !env.IsDraw())
+        r.winner = env.GetWinner();
+    return r;
+}
+
+struct Run
+{
+    double seconds = 0.0;
+    std::vector<GameResult> games;
+};
+
+Run PlayGames(const std::vector<std::string>& mix, int games, int seed, int maxSteps, int threads)
+{
+    Run run;
+    run.games.resize(games);
+    std::atomic<int> next(0);
+    auto work = [&]
+    {
+        for(int g = next++; g < games; g = next++)
+            run.games[g] = PlayGame(mix, seed + g, maxSteps, threads > 1);
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for(int t = 1; t < threads; t++)
+        workers.emplace_back(work);
+    work();
+    for(std::thread& t : workers)
+        t.join();
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return run;
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::ParseOptions(argc, argv);
+    std::string mixName = "simple,simple,simple,simple";
+    int games = 50, seed = 1, maxSteps = 800, threads = 0;
+    for(size_t i = 0; i + 1 < options.rest.size(); i += 2)
+    {
+        if(options.rest[i] == "--agents")
+            mixName = options.rest[i + 1];
+        else if(options.rest[i] == "--games")
+            games = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--seed")
+            seed = std::atoi(options.rest[i + 1].c_str());
+        else if(options.rest[i] == "--max-steps")
+            maxSteps = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--threads")
+            threads = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+    }
+
+    std::vector<std::string> mix;
+    std::istringstream names(mixName);
+    for(std::string name; std::getline(names, name, ',');)
+        mix.push_back(name);
+    for(int i = 0; i < (int)mix.size(); i++)
+    {
+        if(!MakeAgent(mix[i], i, 0, false))
+        {
+            std::cerr << "Unknown agent " << mix[i] << std::endl;
+            return 1;
+        }
+    }
+    if(mix.size() != AGENT_COUNT)
+    {
+        std::cerr << "--agents needs " << AGENT_COUNT << " agents, separated by commas" << std::endl;
+        return 1;
+    }
+
+    std::vector<int> threadCounts;
+    if(threads > 0)
+        threadCounts.push_back(threads);
+    else
+    {
+        threadCounts.push_back(1);
+        const int cores = (int)std::thread::hardware_concurrency();
+        if(cores > 1)
+            threadCounts.push_back(cores);
+    }
+
+    // the decisions of the search agents would be printed, unless they are logged
+    setenv("POMMERMAN_DECISION_LOG", "/dev/null", 0);
+    if(mixName.find("gottingen") != std::string::npos)
+        agents::GottingenAgent::Calibrate();
+
+    bench::Runner runner(options);
+    std::cout << mixName << ", " << games << " games" << std::endl;
+    std::cout << std::right << std::setw(8) << "threads" << std::setw(12) << "games/s" << std::setw(12) << "steps/s"
+              << std::setw(12) << "steps/game" << "   wins 0/1/2/3, draws" << std::endl;
+    for(int t : threadCounts)
+    {
+        const std::string name = "games/" + mixName + "/" + std::to_string(t) + "threads";
+        if(!options.filter.empty() && name.find(options.filter) == std::string::npos)
+            continue;
+
+        // the observation conversion of the search agents talks about the bombs it sees
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        const Run run = PlayGames(mix, games, seed, maxSteps, t);
+        std::cout.rdbuf(out);
+        std::cout.clear();
+
+        int64_t steps = 0;
+        int wins[AGENT_COUNT] = {}, draws = 0;
+        for(const GameResult& g : run.games)
+        {
+            steps += g.steps;
+            if(g.winner >= 0)
+                wins[g.winner]++;
+            else
+                draws++;
+        }
+
+        const std::ios::fmtflags flags = std::cout.flags();
+        std::cout << std::setw(8) << t << std::fixed << std::setprecision(1) << std::setw(12) << games / run.seconds
+                  << std::setprecision(0) << std::setw(12) << steps / run.seconds << std::setprecision(1)
+                  << std::setw(12) << (double)steps / games << "   " << wins[0] << "/" << wins[1] << "/" << wins[2]
+                  << "/" << wins[3] << ", " << draws << std::endl;
+        std::cout.flags(flags);
+        std::cout.precision(6);
+
+        const double nsPerGame = run.seconds * 1e9 / games;
+        runner.Add({name, nsPerGame, nsPerGame, 0.0, games, 1}, false);
+    }
+
+    return runner.Finish() ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "bridge.hpp"
+#include "scenario.hpp"
+
+/**
+ * The decision latency of the search agents over the scenario corpus.
+ * Every scenario is decided --runs times through the C ABI, the way the
+ * Python agents call it, each time by a fresh agent. The latency is the
+ * time of the c_getStep_* call (observation conversion and act), the
+ * speed of the search is that time per simulated step.
+ *
+ * Usage: latency_benchmark [--corpus dir] [--runs n] [--agent name]
+ *                          [--filter s] [--out file] [--baseline file]
+ */
+
+struct SearchAgentApi
+{
+    const char* name;
+    decltype(&c_init_agent_gottingen) init;
+    decltype(&c_getStep_gottingen) getStep;
+    decltype(&c_getSearchStats_gottingen) getStats;
+};
+
+const SearchAgentApi AGENTS[] =
+{
+    {"frankfurt", c_init_agent_frankfurt, c_getStep_frankfurt, c_getSearchStats_frankfurt},
+    {"gottingen", c_init_agent_gottingen, c_getStep_gottingen, c_getSearchStats_gottingen}
+};
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::ParseOptions(argc, argv);
+    std::string corpus = "benchmark/scenarios";
+    std::string agentName;
+    int runs = 20;
+    for(size_t i = 0; i + 1 < options.rest.size(); i += 2)
+    {
+        if(options.rest[i] == "--corpus")
+            corpus = options.rest[i + 1];
+        else if(options.rest[i] == "--runs")
+            runs = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--agent")
+            agentName = options.rest[i + 1];
+    }
+
+    std::vector<bench::Scenario> scenarios;
+    std::string error;
+    if(!bench::LoadScenarios(corpus, scenarios, error) || scenarios.empty())
+    {
+        std::cerr << (error.empty() ? "No scenarios in " + corpus : error) << std::endl;
+        return 1;
+    }
+
+    // the decisions of the agents would be printed, unless they are logged
+    setenv("POMMERMAN_DECISION_LOG", "/dev/null", 0);
+
+    bench::Runner runner(options);
+    bench::Observation obs;
+    int totalRuns = 0, correctRuns = 0;
+
+    std::cout << std::left << std::setw(36) << "scenario" << std::right << std::setw(9) << "p50 ms" << std::setw(9)
+              << "p90 ms" << std::setw(9) << "p99 ms" << std::setw(9) << "max ms" << std::setw(12) << "nodes"
+              << std::setw(10) << "correct" << std::endl;
+    for(const SearchAgentApi& agent : AGENTS)
+    {
+        if(!agentName.empty() && agentName != agent.name)
+            continue;
+        for(const bench::Scenario& s : scenarios)
+        {
+            const std::string name = std::string(agent.name) + "/" + s.name;
+            if(!options.filter.empty() && name.find(options.filter) == std::string::npos)
+                continue;
+
+            std::vector<double> millis, nsPerNode;
+            double nodes = 0.0;
+            int correct = 0;
+            for(int r = 0; r < runs; r++)
+            {
+                agent.init(s.id);
+                c_setTimeStep(s.id, s.timeStep - 1);
+                obs.CopyFrom(s);
+
+                const auto start = std::chrono::steady_clock::now();
+                const int move = agent.getStep(s.id, s.alive[0], s.alive[1], s.alive[2], s.alive[3], obs.board,
+                                               obs.bombLife, obs.bombBlastStrength, obs.bombMovingDirection,
+                                               obs.flameLife, s.posx, s.posy, s.blastStrength, s.canKick, s.ammo,
+                                               s.gameType, s.teammateId, s.message[0], s.message[1]);
+                millis.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+                agents::SearchStats stats;
+                agent.getStats(s.id, &stats);
+                nodes += stats.TotalNodes();
+                if(stats.TotalNodes() > 0)
+                    nsPerNode.push_back(millis.back() * 1e6 / stats.TotalNodes());
+                correct += s.IsCorrect(move);
+            }
+            totalRuns += runs;
+            correctRuns += correct;
+
+            const double p50 = bench::Percentile(millis, 50), p99 = bench::Percentile(millis, 99);
+            const std::ios::fmtflags flags = std::cout.flags();
+            std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(9) << p50 << std::setw(9) << bench::Percentile(millis, 90) << std::setw(9) << p99
+                      << std::setw(9) << bench::Percentile(millis, 100) << std::setw(12) << std::setprecision(0)
+                      << nodes / runs << std::setw(7) << correct << "/" << runs << std::endl;
+            std::cout.flags(flags);
+            std::cout.precision(6);
+
+            std::vector<double> deviations;
+            for(double m : millis)
+                deviations.push_back(std::abs(m - p50));
+            const bench::Result result {"latency/" + name, p50 * 1e6, bench::Percentile(millis, 0) * 1e6,
+                                  p50 > 0 ? bench::Median(deviations) / p50 : 0.0, 1, runs};
+            // the median only, the tail of a few runs is too noisy to compare
+            runner.Add(result, false);
+
+            // the speed of the search, if there was one
+            if(!nsPerNode.empty())
+            {
+                const double median = bench::Median(nsPerNode);
+                deviations.clear();
+                for(double ns : nsPerNode)
+                    deviations.push_back(std::abs(ns - median));
+                runner.Add({"search/" + name, median, bench::Percentile(nsPerNode, 0), bench::Median(deviations) / median,
+                            (int64_t)(nodes / runs), (int)nsPerNode.size()}, false);
+            }
+        }
+    }
+
+    std::cout << std::endl << "From " << totalRuns << " decisions " << correctRuns << " were correct" << std::endl;
+    return runner.Finish() ? 0 : 1;
+}
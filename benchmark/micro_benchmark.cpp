@@ -0,0 +1,235 @@
+#include <iostream>
+#include <memory>
+
+#include "benchmark.hpp"
+
+#include "bboard.hpp"
+#include "step_utility.hpp"
+#include "strategy.hpp"
+
+using namespace bboard;
+
+/**
+ * Benchmarks of the engine primitives on fixed states. Step and
+ * TickAndMoveBombs change the state, so every operation copies the
+ * state first: subtract "state/copy" to get the primitive alone.
+ *
+ * Usage: micro_benchmark [--filter s] [--reps n] [--out file] [--baseline file] ...
+ */
+
+const Move IDLE = Move::IDLE;
+
+/**
+ * @brief Scenario A state and the joint move which is stepped from it
+ */
+struct Scenario
+{
+    std::unique_ptr<State> state = std::make_unique<State>();
+    Move moves[AGENT_COUNT] = {IDLE, IDLE, IDLE, IDLE};
+};
+
+/**
+ * @brief Quiet The start of a standard game, the agents walk
+ */
+Scenario Quiet()
+{
+    Scenario s;
+    InitState(s.state.get(), 0, 1, 2, 3);
+    s.moves[0] = Move::RIGHT;
+    s.moves[1] = Move::DOWN;
+    s.moves[2] = Move::LEFT;
+    s.moves[3] = Move::UP;
+    return s;
+}
+
+/**
+ * @brief ManyBombs 16 ticking bombs on a standard board, none of them
+ * explodes in the step
+ */
+Scenario ManyBombs()
+{
+    Scenario s = Quiet();
+    State& st = *s.state;
+    for(AgentInfo& a : st.agents)
+        a.maxBombCount = MAX_BOMBS_PER_AGENT;
+
+    // the queue is sorted by the lifetime
+    int planted = 0;
+    for(int y = 1; y < BOARD_SIZE - 1 && planted < 16; y += 2)
+    {
+        for(int x = 1; x < BOARD_SIZE - 1 && planted < 16; x += 2)
+        {
+            if(st.board[y][x] != PASSAGE)
+                continue;
+            st.PlantBombModifiedLife(x, y, planted % AGENT_COUNT, 2 + planted / 2, true);
+            planted++;
+        }
+    }
+    return s;
+}
+
+/**
+ * @brief Kicks Every agent kicks a bomb, two more bombs are already
+ * moving towards each other
+ */
+Scenario Kicks()
+{
+    Scenario s;
+    State& st = *s.state;
+    const int agentPos[AGENT_COUNT][2] = {{1, 1}, {9, 1}, {9, 9}, {1, 9}};
+    const Move kick[AGENT_COUNT] = {Move::RIGHT, Move::DOWN, Move::LEFT, Move::UP};
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        st.PutAgent(agentPos[i][0], agentPos[i][1], i);
+        st.agents[i].canKick = true;
+        st.agents[i].maxBombCount = MAX_BOMBS_PER_AGENT;
+        s.moves[i] = kick[i];
+    }
+    st.PlantBombModifiedLife(2, 1, 0, 5, true);
+    st.PlantBombModifiedLife(9, 2, 1, 5, true);
+    st.PlantBombModifiedLife(8, 9, 2, 6, true);
+    st.PlantBombModifiedLife(1, 8, 3, 6, true);
+    st.PlantBombModifiedLife(3, 5, 0, 7, true);
+    SetBombDirection(st.bombs[4], Direction::RIGHT);
+    st.PlantBombModifiedLife(7, 5, 1, 7, true);
+    SetBombDirection(st.bombs[5], Direction::LEFT);
+    return s;
+}
+
+/**
+ * @brief Chains A bomb explodes and sets off a chain of 8 more bombs
+ * over wood
+ */
+Scenario Chains()
+{
+    Scenario s;
+    State& st = *s.state;
+    st.PutAgentsInCorners(0, 1, 2, 3);
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        st.agents[i].maxBombCount = MAX_BOMBS_PER_AGENT;
+        st.agents[i].bombStrength = 2;
+    }
+    for(int x = 0; x < BOARD_SIZE; x++)
+        st.board[4][x] = st.board[6][x] = Item::WOOD;
+
+    // first along row 5, then back along row 3
+    const int chain[9][2] = {{1, 5}, {3, 5}, {5, 5}, {7, 5}, {9, 5}, {9, 3}, {7, 3}, {5, 3}, {3, 3}};
+    for(int i = 0; i < 9; i++)
+        st.PlantBombModifiedLife(chain[i][0], chain[i][1], i % AGENT_COUNT, i == 0 ? 1 : 9, true);
+    st.board[4][9] = PASSAGE;
+    return s;
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::ParseOptions(argc, argv);
+    bench::Runner runner(options);
+
+    struct { const char* name; Scenario scenario; } scenarios[] =
+    {
+        {"quiet", Quiet()}, {"bombs", ManyBombs()}, {"kicks", Kicks()}, {"chains", Chains()}
+    };
+
+    // the scenarios have to do what their name says
+    {
+        State chains = *scenarios[3].scenario.state;
+        Step(&chains, scenarios[3].scenario.moves);
+        State kicks = *scenarios[2].scenario.state;
+        Step(&kicks, scenarios[2].scenario.moves);
+        if(chains.bombs.count != 0 || chains.flames.count != 9 || BMB_DIR(kicks.bombs[0]) == 0)
+            std::cerr << "Warning: the scenarios don't play out as expected" << std::endl;
+    }
+
+    State copy;
+    State& base = *scenarios[0].scenario.state;
+    runner.Run("state/copy", [&](int64_t n)
+    {
+        for(int64_t i = 0; i < n; i++)
+        {
+            copy = base;
+            bench::DoNotOptimize(copy);
+        }
+    });
+
+    for(auto& s : scenarios)
+    {
+        const State& start = *s.scenario.state;
+        Move* moves = s.scenario.moves;
+        runner.Run(std::string("step/") + s.name, [&](int64_t n)
+        {
+            for(int64_t i = 0; i < n; i++)
+            {
+                copy = start;
+                bench::DoNotOptimize(Step(&copy, moves));
+            }
+        });
+    }
+
+    const State& bombs = *scenarios[1].scenario.state;
+    runner.Run("tick_and_move_bombs/bombs", [&](int64_t n)
+    {
+        for(int64_t i = 0; i < n; i++)
+        {
+            copy = bombs;
+            util::TickAndMoveBombs(copy);
+            bench::DoNotOptimize(copy);
+        }
+    });
+    runner.Run("tick_and_move_bombs/kicks", [&](int64_t n)
+    {
+        for(int64_t i = 0; i < n; i++)
+        {
+            copy = *scenarios[2].scenario.state;
+            util::TickAndMoveBombs(copy);
+            bench::DoNotOptimize(copy);
+        }
+    });
+
+    // a flame is spawned and extinguished again, the board stays the same
+    // after the first operation (the wood in range is gone)
+    State flames = base;
+    for(int strength : {1, 4})
+    {
+        runner.Run("spawn_pop_flame/strength" + std::to_string(strength), [&](int64_t n)
+        {
+            for(int64_t i = 0; i < n; i++)
+            {
+                flames.SpawnFlame(5, 5, strength, 0);
+                flames.PopFlame();
+                bench::DoNotOptimize(flames);
+            }
+        });
+    }
+
+    strategy::RMap r;
+    runner.Run("fill_rmap/quiet", [&](int64_t n)
+    {
+        for(int64_t i = 0; i < n; i++)
+        {
+            strategy::FillRMap(base, r, 0);
+            bench::DoNotOptimize(r);
+        }
+    });
+    runner.Run("fill_rmap/bombs", [&](int64_t n)
+    {
+        for(int64_t i = 0; i < n; i++)
+        {
+            strategy::FillRMap(bombs, r, 0);
+            bench::DoNotOptimize(r);
+        }
+    });
+
+    // all positions of the board in turn, 16 of them have a bomb
+    runner.Run("has_bomb/bombs", [&](int64_t n)
+    {
+        int p = 0;
+        for(int64_t i = 0; i < n; i++)
+        {
+            bench::DoNotOptimize(bombs.HasBomb(p % BOARD_SIZE, p / BOARD_SIZE));
+            p = p + 1 < BOARD_SIZE * BOARD_SIZE ? p + 1 : 0;
+        }
+    });
+
+    return runner.Finish() ? 0 : 1;
+}
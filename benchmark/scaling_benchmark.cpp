@@ -0,0 +1,228 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "scenario.hpp"
+
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+/**
+ * How the parallel search scales with the threads of the root moves.
+ * Every position of the scenario corpus is searched by a fresh agent with
+ * 1, 2, 4, ... threads (SearchAgent::rootThreads, at most 6: the root has
+ * 6 moves). The turn deadline is lifted and the kill solver is off, so
+ * every search does the same work with any number of threads: the speedup
+ * is the ratio of the wall times, the efficiency the speedup per thread.
+ *
+ * The imbalance of a search is the busiest thread's time of the root
+ * moves over the average of the threads (1 is perfect). The bound is the
+ * speedup with one thread per root move: all root moves over the
+ * slowest one.
+ *
+ * Usage: scaling_benchmark [--corpus dir] [--runs n] [--agent name]
+ *                          [--max-threads n] [--filter s] [--out file]
+ *                          [--baseline file]
+ */
+
+const char* MOVE_NAMES[6] = {"IDLE", "UP", "DOWN", "LEFT", "RIGHT", "BOMB"};
+
+struct Search
+{
+    double millis = 0.0;
+    int64_t nodes = 0;
+    double rootMoveMillis[6] = {};
+    int rootMoveThread[6] = {};
+};
+
+/**
+ * @brief Decide Searches the scenario like c_getStep_* does, without the
+ * time limit
+ */
+template<typename A>
+Search Decide(const bench::Scenario& s, int threads)
+{
+    Environment view;
+    view.MakeGameFromPython(s.id);
+    view.GetState().timeStep = s.timeStep - 1;
+    bench::Convert(s, view, std::is_same<A, agents::FrankfurtAgent>::value);
+
+    auto agent = std::make_unique<A>();
+    agent->id = view.GetState().ourId;
+    agent->verbose = false;
+    agent->useKillSolver = false;
+    agent->rootThreads = threads;
+    agent->timeLimit = false;
+    agent->start_time = std::chrono::high_resolution_clock::now();
+    agent->act(&view.GetState());
+
+    Search r;
+    r.millis = agent->stats.searchMillis;
+    r.nodes = agent->stats.TotalNodes();
+    for(int i = 0; i < 6; i++)
+    {
+        r.rootMoveMillis[i] = agent->rootMoveMillis[i];
+        r.rootMoveThread[i] = agent->rootMoveThread[i];
+    }
+    return r;
+}
+
+template<typename A>
+void Benchmark(const std::string& name, const std::vector<bench::Scenario>& scenarios, int runs,
+               const std::vector<int>& threadCounts, bench::Runner& runner)
+{
+    // the positions without a search (a forced move) don't count
+    std::vector<const bench::Scenario*> positions;
+    std::vector<int64_t> nodes;
+    for(const bench::Scenario& s : scenarios)
+    {
+        const Search probe = Decide<A>(s, 1);
+        if(probe.nodes > 0)
+        {
+            positions.push_back(&s);
+            nodes.push_back(probe.nodes);
+        }
+    }
+    if(positions.empty())
+        return;
+
+    double baseMillis = 0.0;
+    double moveShare[6] = {};
+    const std::ios::fmtflags flags = std::cout.flags();
+    std::cout << std::fixed;
+    for(int threads : threadCounts)
+    {
+        double millis = 0.0, imbalance = 0.0, bound = 0.0;
+        int64_t totalNodes = 0;
+        int usedThreads = 0;
+        bool sameWork = true;
+        std::vector<double> nsPerNode;
+        for(size_t p = 0; p < positions.size(); p++)
+        {
+            // the median run of the position
+            std::vector<Search> searches;
+            std::vector<double> times;
+            for(int r = 0; r < runs; r++)
+            {
+                searches.push_back(Decide<A>(*positions[p], threads));
+                times.push_back(searches.back().millis);
+            }
+            const double median = bench::Median(times);
+            const Search& s = *std::min_element(searches.begin(), searches.end(), [&](const Search& a, const Search& b)
+            {
+                return std::abs(a.millis - median) < std::abs(b.millis - median);
+            });
+            sameWork &= s.nodes == nodes[p];
+            millis += s.millis;
+            totalNodes += s.nodes;
+            nsPerNode.push_back(s.millis * 1e6 / s.nodes);
+
+            double busy[6] = {}, total = 0.0, slowest = 0.0;
+            for(int m = 0; m < 6; m++)
+            {
+                if(s.rootMoveThread[m] >= 0)
+                    busy[s.rootMoveThread[m]] += s.rootMoveMillis[m];
+                total += s.rootMoveMillis[m];
+                slowest = std::max(slowest, s.rootMoveMillis[m]);
+                usedThreads = std::max(usedThreads, s.rootMoveThread[m] + 1);
+                if(threads == 1)
+                    moveShare[m] += s.rootMoveMillis[m];
+            }
+            if(total > 0)
+            {
+                imbalance += *std::max_element(busy, busy + threads) / (total / threads);
+                bound += total / slowest;
+            }
+        }
+        imbalance /= positions.size();
+        bound /= positions.size();
+        if(threads == 1)
+            baseMillis = millis;
+        const double speedup = baseMillis / millis;
+
+        std::cout << std::left << std::setw(12) << name << std::right << std::setw(8) << threads << std::setprecision(1)
+                  << std::setw(12) << millis << std::setprecision(2) << std::setw(10) << speedup << std::setprecision(0)
+                  << std::setw(11) << 100.0 * speedup / threads << "%" << std::setprecision(2) << std::setw(11)
+                  << imbalance << std::setw(8) << bound << std::endl;
+        if(!sameWork)
+            std::cout << "  the searches differ from the one with 1 thread, the times aren't comparable" << std::endl;
+        if(threads > 1 && usedThreads < 2)
+            std::cout << "  the search ran on one thread, the library is built without OpenMP" << std::endl;
+
+        std::vector<double> deviations;
+        const double median = bench::Median(nsPerNode);
+        for(double ns : nsPerNode)
+            deviations.push_back(std::abs(ns - median));
+        runner.Add({"scaling/" + name + "/" + std::to_string(threads) + "threads", millis * 1e6 / totalNodes,
+                    bench::Percentile(nsPerNode, 0), median > 0 ? bench::Median(deviations) / median : 0.0,
+                    totalNodes, runs}, false);
+    }
+
+    double shareTotal = 0.0;
+    for(double m : moveShare)
+        shareTotal += m;
+    std::cout << "  time of the root moves (1 thread):";
+    for(int m = 0; m < 6; m++)
+        std::cout << " " << MOVE_NAMES[m] << " " << std::setprecision(0) << 100.0 * moveShare[m] / shareTotal << "%";
+    std::cout << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(6);
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::ParseOptions(argc, argv);
+    std::string corpus = "benchmark/scenarios";
+    std::string agentName;
+    int runs = 5;
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    for(size_t i = 0; i + 1 < options.rest.size(); i += 2)
+    {
+        if(options.rest[i] == "--corpus")
+            corpus = options.rest[i + 1];
+        else if(options.rest[i] == "--runs")
+            runs = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--agent")
+            agentName = options.rest[i + 1];
+        else if(options.rest[i] == "--max-threads")
+            maxThreads = std::atoi(options.rest[i + 1].c_str());
+    }
+    // more threads than root moves would have nothing to do
+    maxThreads = std::min(6, std::max(1, maxThreads));
+    std::vector<int> threadCounts;
+    for(int t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    std::vector<bench::Scenario> scenarios;
+    std::string error;
+    if(!bench::LoadScenarios(corpus, scenarios, error) || scenarios.empty())
+    {
+        std::cerr << (error.empty() ? "No scenarios in " + corpus : error) << std::endl;
+        return 1;
+    }
+
+    // the depth of Gottingen depends on the calibrated speed, it is the same for every thread count
+    agents::GottingenAgent::Calibrate();
+
+    bench::Runner runner(options);
+    std::cout << std::left << std::setw(12) << "agent" << std::right << std::setw(8) << "threads" << std::setw(12)
+              << "ms" << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << std::setw(11) << "imbalance"
+              << std::setw(8) << "bound" << std::endl;
+    if(agentName.empty() || agentName == "frankfurt")
+        Benchmark<agents::FrankfurtAgent>("frankfurt", scenarios, runs, threadCounts, runner);
+    if(agentName.empty() || agentName == "gottingen")
+        Benchmark<agents::GottingenAgent>("gottingen", scenarios, runs, threadCounts, runner);
+
+    return runner.Finish() ? 0 : 1;
+}
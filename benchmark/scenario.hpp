@@ -0,0 +1,350 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bboard.hpp"
+
+/**
+ * A scenario is one observation of an agent, as the Python side passes it
+ * to c_getStep_*, and the moves which are correct in it. The corpus is a
+ * directory of text files (the .scn files in benchmark/scenarios):
+ *
+ *   # comment, the first comment lines are the description
+ *   id 1                  the agent (0-3)
+ *   alive 1 1 1 1         agent0Alive .. agent3Alive
+ *   position 4 4          posx posy
+ *   blast_strength 1
+ *   can_kick 1
+ *   ammo 0
+ *   game_type 2           bboard::GameType
+ *   teammate 13           teammate_id (a PyItem)
+ *   messages -1 -1
+ *   time_step 100         the turn of the observation (default 1, the first)
+ *   expect 3 4            the correct moves (default: any)
+ *   board                 followed by 11 rows of 11 PyItems
+ *   bomb_life             bomb_blast_strength, bomb_moving_direction and
+ *                         flame_life like the board, zero if missing
+ */
+namespace bench
+{
+
+const int CELLS = 11 * 11;
+
+struct Scenario
+{
+    std::string name;
+    std::string description;
+    int id = 0;
+    bool alive[4] = {true, true, true, true};
+    int posx = 0;
+    int posy = 0;
+    int blastStrength = 1;
+    bool canKick = false;
+    int ammo = 1;
+    int gameType = 2;
+    int teammateId = -1;
+    int message[2] = {-1, -1};
+    int timeStep = 1;
+    std::vector<int> expected;
+
+    uint8_t board[CELLS] = {};
+    double bombLife[CELLS] = {};
+    double bombBlastStrength[CELLS] = {};
+    double bombMovingDirection[CELLS] = {};
+    double flameLife[CELLS] = {};
+
+    bool IsCorrect(int move) const
+    {
+        return expected.empty() || std::find(expected.begin(), expected.end(), move) != expected.end();
+    }
+};
+
+/**
+ * @brief The arrays of a scenario, c_getStep_* modifies them
+ */
+struct Observation
+{
+    uint8_t board[CELLS];
+    double bombLife[CELLS];
+    double bombBlastStrength[CELLS];
+    double bombMovingDirection[CELLS];
+    double flameLife[CELLS];
+
+    void CopyFrom(const Scenario& s)
+    {
+        std::copy(s.board, s.board + CELLS, board);
+        std::copy(s.bombLife, s.bombLife + CELLS, bombLife);
+        std::copy(s.bombBlastStrength, s.bombBlastStrength + CELLS, bombBlastStrength);
+        std::copy(s.bombMovingDirection, s.bombMovingDirection + CELLS, bombMovingDirection);
+        std::copy(s.flameLife, s.flameLife + CELLS, flameLife);
+    }
+};
+
+/**
+ * @brief Observe The observation of agent `id` of a fully visible state,
+ * the way the Python environment encodes it
+ */
+inline void Observe(const bboard::State& state, int id, Scenario& s)
+{
+    using namespace bboard;
+    s.id = id;
+    for(int i = 0; i < AGENT_COUNT; i++)
+        s.alive[i] = !state.agents[i].dead;
+    const AgentInfo& me = state.agents[id];
+    // (row, column)
+    s.posx = me.y;
+    s.posy = me.x;
+    s.blastStrength = me.bombStrength + 1;
+    s.canKick = me.canKick;
+    s.ammo = me.maxBombCount - me.bombCount;
+    s.gameType = GameType::Team;
+    s.teammateId = PyAGENT0 + (id + 2) % AGENT_COUNT;
+    s.timeStep = state.timeStep;
+
+    std::fill(s.bombLife, s.bombLife + CELLS, 0.0);
+    std::fill(s.bombBlastStrength, s.bombBlastStrength + CELLS, 0.0);
+    std::fill(s.bombMovingDirection, s.bombMovingDirection + CELLS, 0.0);
+    std::fill(s.flameLife, s.flameLife + CELLS, 0.0);
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            const int item = state.board[y][x];
+            uint8_t& py = s.board[x + BOARD_SIZE * y];
+            if(IS_AGENT(item))
+                py = PyAGENT0 + (item - AGENT0);
+            else if(IS_WOOD(item))
+                py = PyWOOD;
+            else if(IS_FLAME(item))
+            {
+                py = PyFLAMES;
+                for(int f = 0; f < state.flames.count; f++)
+                {
+                    const Position& o = state.flames[f].position;
+                    if(FLAME_ID(item) == o.x + BOARD_SIZE * o.y)
+                        s.flameLife[x + BOARD_SIZE * y] = state.flames[f].timeLeft;
+                }
+            }
+            else
+                py = (uint8_t)item; // the other items have the same values
+        }
+    }
+    // bombs under agents are only in the bomb arrays
+    for(int i = 0; i < state.bombs.count; i++)
+    {
+        const Bomb b = state.bombs[i];
+        const int cell = BMB_POS_X(b) + BOARD_SIZE * BMB_POS_Y(b);
+        s.bombLife[cell] = BMB_TIME(b);
+        s.bombBlastStrength[cell] = BMB_STRENGTH(b) + 1;
+        s.bombMovingDirection[cell] = BMB_DIR(b);
+    }
+}
+
+/**
+ * @brief Convert Passes the observation to the Environment of an agent
+ * like c_getStep_frankfurt (or c_getStep_gottingen) does, which keeps
+ * what it learned from the earlier observations
+ */
+inline void Convert(const Scenario& s, bboard::Environment& view, bool frankfurt)
+{
+    // the conversion writes into the arrays
+    Observation obs;
+    obs.CopyFrom(s);
+    auto makeGame = frankfurt ? &bboard::Environment::MakeGameFromPython_frankfurt
+                              : &bboard::Environment::MakeGameFromPython_gottingen;
+    (view.*makeGame)(s.alive[0], s.alive[1], s.alive[2], s.alive[3], obs.board, obs.bombLife, obs.bombBlastStrength,
+                     obs.bombMovingDirection, obs.flameLife, s.posx, s.posy, s.blastStrength, s.canKick, s.ammo,
+                     s.gameType, s.teammateId, s.message[0], s.message[1]);
+}
+
+template<typename T>
+bool ReadGrid(std::istream& in, T* grid)
+{
+    for(int i = 0; i < CELLS; i++)
+    {
+        double v;
+        if(!(in >> v))
+            return false;
+        grid[i] = (T)v;
+    }
+    return true;
+}
+
+/**
+ * @brief LoadScenario Reads a scenario file, false (and the reason in
+ * error) if it isn't one
+ */
+inline bool LoadScenario(const std::string& path, Scenario& s, std::string& error)
+{
+    std::ifstream in(path);
+    if(!in)
+    {
+        error = "couldn't open " + path;
+        return false;
+    }
+    s = Scenario();
+    s.name = std::filesystem::path(path).stem().string();
+
+    bool hasBoard = false;
+    bool inDescription = true;
+    std::string line;
+    while(std::getline(in, line))
+    {
+        if(line.empty())
+            continue;
+        if(line[0] == '#')
+        {
+            const size_t start = line.find_first_not_of("# ");
+            if(inDescription && start != std::string::npos)
+                s.description += (s.description.empty() ? "" : " ") + line.substr(start);
+            continue;
+        }
+        inDescription = false;
+
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        bool ok = true;
+        if(key == "id")
+            ok = (bool)(fields >> s.id) && s.id >= 0 && s.id < 4;
+        else if(key == "alive")
+            ok = (bool)(fields >> s.alive[0] >> s.alive[1] >> s.alive[2] >> s.alive[3]);
+        else if(key == "position")
+            ok = (bool)(fields >> s.posx >> s.posy);
+        else if(key == "blast_strength")
+            ok = (bool)(fields >> s.blastStrength);
+        else if(key == "can_kick")
+            ok = (bool)(fields >> s.canKick);
+        else if(key == "ammo")
+            ok = (bool)(fields >> s.ammo);
+        else if(key == "game_type")
+            ok = (bool)(fields >> s.gameType);
+        else if(key == "teammate")
+            ok = (bool)(fields >> s.teammateId);
+        else if(key == "messages")
+            ok = (bool)(fields >> s.message[0] >> s.message[1]);
+        else if(key == "time_step")
+            ok = (bool)(fields >> s.timeStep);
+        else if(key == "expect")
+        {
+            int move;
+            while(fields >> move)
+                s.expected.push_back(move);
+        }
+        else if(key == "board")
+            ok = hasBoard = ReadGrid(in, s.board);
+        else if(key == "bomb_life")
+            ok = ReadGrid(in, s.bombLife);
+        else if(key == "bomb_blast_strength")
+            ok = ReadGrid(in, s.bombBlastStrength);
+        else if(key == "bomb_moving_direction")
+            ok = ReadGrid(in, s.bombMovingDirection);
+        else if(key == "flame_life")
+            ok = ReadGrid(in, s.flameLife);
+        else
+        {
+            error = path + ": unknown key " + key;
+            return false;
+        }
+        if(!ok)
+        {
+            error = path + ": bad value of " + key;
+            return false;
+        }
+    }
+    if(!hasBoard)
+    {
+        error = path + ": no board";
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+void WriteGrid(std::ostream& out, const char* key, const T* grid, bool optional = true)
+{
+    // LoadScenario fills the missing grids with zeros
+    if(optional && std::all_of(grid, grid + CELLS, [](T v) { return v == 0; }))
+        return;
+    out << key << "\n";
+    for(int i = 0; i < CELLS; i++)
+        out << (double)grid[i] << (i % 11 == 10 ? "\n" : " ");
+}
+
+/**
+ * @brief SaveScenario Writes a scenario file which LoadScenario reads
+ * back, false if it can't be written
+ */
+inline bool SaveScenario(const std::string& path, const Scenario& s)
+{
+    std::ofstream out(path);
+    if(!out)
+        return false;
+    if(!s.description.empty())
+        out << "# " << s.description << "\n";
+    out << "id " << s.id << "\n"
+        << "alive " << s.alive[0] << " " << s.alive[1] << " " << s.alive[2] << " " << s.alive[3] << "\n"
+        << "position " << s.posx << " " << s.posy << "\n"
+        << "blast_strength " << s.blastStrength << "\n"
+        << "can_kick " << s.canKick << "\n"
+        << "ammo " << s.ammo << "\n"
+        << "game_type " << s.gameType << "\n"
+        << "teammate " << s.teammateId << "\n"
+        << "messages " << s.message[0] << " " << s.message[1] << "\n"
+        << "time_step " << s.timeStep << "\n";
+    if(!s.expected.empty())
+    {
+        out << "expect";
+        for(int move : s.expected)
+            out << " " << move;
+        out << "\n";
+    }
+    WriteGrid(out, "board", s.board, false);
+    WriteGrid(out, "bomb_life", s.bombLife);
+    WriteGrid(out, "bomb_blast_strength", s.bombBlastStrength);
+    WriteGrid(out, "bomb_moving_direction", s.bombMovingDirection);
+    WriteGrid(out, "flame_life", s.flameLife);
+    return (bool)out;
+}
+
+/**
+ * @brief LoadScenarios Reads all *.scn files of the directory, sorted by
+ * their names
+ */
+inline bool LoadScenarios(const std::string& dir, std::vector<Scenario>& scenarios, std::string& error)
+{
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for(const auto& entry : std::filesystem::directory_iterator(dir, ec))
+    {
+        if(entry.path().extension() == ".scn")
+            paths.push_back(entry.path().string());
+    }
+    if(ec)
+    {
+        error = "couldn't list " + dir + ": " + ec.message();
+        return false;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    scenarios.clear();
+    for(const std::string& p : paths)
+    {
+        Scenario s;
+        if(!LoadScenario(p, s, error))
+            return false;
+        scenarios.push_back(s);
+    }
+    return true;
+}
+
+}
+
+#endif // SCENARIO_H
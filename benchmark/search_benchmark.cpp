@@ -0,0 +1,195 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "bridged_agent.hpp"
+
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+/**
+ * The throughput of the search agents over whole games. Team 0/2 is
+ * played by the search agent, team 1/3 by SimpleAgents (or by the search
+ * agent as well, with --self-play). Every turn the search agent gets the
+ * observation of the Python environment (bench::Observe) through
+ * MakeGameFromPython_*, with its own Environment like in bboard.cpp, so it
+ * runs the same code as behind c_getStep_*. The board is fully visible.
+ *
+ * The reported simulated steps per turn is the avg.sim.steps printed by
+ * c_episode_end_*, the steps per second are over the time of the turns
+ * (observation conversion and act).
+ *
+ * Usage: search_benchmark [--agent name] [--games n] [--seed s]
+ *                         [--max-steps n] [--self-play 1]
+ *                         [--filter s] [--out file] [--baseline file]
+ */
+
+struct GameResult
+{
+    int steps = 0;
+    // 1 if team 0/2 won, -1 if it lost, 0 for a tie
+    int outcome = 0;
+    // (sums over the searchers of the game, and then over the games)
+    int64_t turns = 0;
+    int64_t simulatedSteps = 0;
+    std::vector<double> turnMillis;
+};
+
+template<typename A>
+GameResult PlayGame(int seed, int maxSteps, bool selfPlay)
+{
+    std::unique_ptr<bench::BridgedAgent<A>> searchers[AGENT_COUNT];
+    agents::SimpleAgent simple[AGENT_COUNT];
+    std::array<Agent*, AGENT_COUNT> players;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(i % 2 == 0 || selfPlay)
+        {
+            searchers[i] = std::make_unique<bench::BridgedAgent<A>>(i);
+            players[i] = searchers[i].get();
+        }
+        else
+        {
+            players[i] = &simple[i];
+        }
+    }
+
+    Environment env;
+    env.MakeGame(players);
+    State& state = env.GetState();
+    InitBoardItems(state, seed);
+    state.PutAgentsInCorners(0, 1, 2, 3);
+
+    auto teamAlive = [&](int team)
+    {
+        return !state.agents[team].dead || !state.agents[team + 2].dead;
+    };
+    // the conversion of the observations talks about the bombs it sees
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    while(!env.IsDone() && state.timeStep < maxSteps && teamAlive(0) && teamAlive(1))
+    {
+        env.Step(false);
+        bench::ForwardMessages(players);
+    }
+    std::cout.rdbuf(out);
+    std::cout.clear();
+
+    GameResult r;
+    r.steps = state.timeStep;
+    r.outcome = teamAlive(0) == teamAlive(1) ? 0 : teamAlive(0) ? 1 : -1;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(!searchers[i])
+            continue;
+        r.turns += searchers[i]->agent.turns;
+        r.simulatedSteps += searchers[i]->agent.totalSimulatedSteps;
+        r.turnMillis.insert(r.turnMillis.end(), searchers[i]->turnMillis.begin(), searchers[i]->turnMillis.end());
+    }
+    return r;
+}
+
+/**
+ * @brief RelativeMad The median absolute deviation of the values relative
+ * to their median
+ */
+double RelativeMad(const std::vector<double>& values)
+{
+    const double median = bench::Median(values);
+    std::vector<double> deviations;
+    for(double v : values)
+        deviations.push_back(std::abs(v - median));
+    return median > 0 ? bench::Median(deviations) / median : 0.0;
+}
+
+template<typename A>
+void Benchmark(const std::string& name, int games, int seed, int maxSteps, bool selfPlay, bench::Runner& runner)
+{
+    std::vector<double> nsPerStep, allTurns;
+    int64_t turns = 0, simulatedSteps = 0;
+    int wins = 0, ties = 0, losses = 0;
+    double millis = 0.0;
+    for(int g = 0; g < games; g++)
+    {
+        const GameResult r = PlayGame<A>(seed + g, maxSteps, selfPlay);
+        double gameMillis = 0.0;
+        for(double m : r.turnMillis)
+            gameMillis += m;
+        if(r.simulatedSteps > 0)
+            nsPerStep.push_back(gameMillis * 1e6 / r.simulatedSteps);
+        allTurns.insert(allTurns.end(), r.turnMillis.begin(), r.turnMillis.end());
+        turns += r.turns;
+        simulatedSteps += r.simulatedSteps;
+        millis += gameMillis;
+        wins += r.outcome > 0;
+        ties += r.outcome == 0;
+        losses += r.outcome < 0;
+    }
+
+    const std::ios::fmtflags flags = std::cout.flags();
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(12) << name << std::right << std::setw(8) << turns << std::fixed
+              << std::setprecision(1) << std::setw(16) << (turns ? simulatedSteps / (double)turns : 0.0)
+              << std::setprecision(0) << std::setw(14) << (millis > 0 ? simulatedSteps / millis * 1000.0 : 0.0)
+              << std::setprecision(2) << std::setw(10) << (turns ? millis / turns : 0.0) << std::setw(10)
+              << bench::Percentile(allTurns, 99) << std::setw(9) << wins << "/" << ties << "/" << losses
+              << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+
+    if(!nsPerStep.empty())
+    {
+        runner.Add({"simulated_step/" + name, bench::Median(nsPerStep), bench::Percentile(nsPerStep, 0),
+                    RelativeMad(nsPerStep), simulatedSteps / (int64_t)nsPerStep.size(), (int)nsPerStep.size()}, false);
+    }
+    if(!allTurns.empty())
+    {
+        runner.Add({"turn/" + name, bench::Median(allTurns) * 1e6, bench::Percentile(allTurns, 0) * 1e6,
+                    RelativeMad(allTurns), 1, (int)allTurns.size()}, false);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::Options options = bench::ParseOptions(argc, argv);
+    std::string agentName;
+    int games = 3, seed = 1, maxSteps = 800;
+    bool selfPlay = false;
+    for(size_t i = 0; i + 1 < options.rest.size(); i += 2)
+    {
+        if(options.rest[i] == "--agent")
+            agentName = options.rest[i + 1];
+        else if(options.rest[i] == "--games")
+            games = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--seed")
+            seed = std::atoi(options.rest[i + 1].c_str());
+        else if(options.rest[i] == "--max-steps")
+            maxSteps = std::max(1, std::atoi(options.rest[i + 1].c_str()));
+        else if(options.rest[i] == "--self-play")
+            selfPlay = std::atoi(options.rest[i + 1].c_str()) != 0;
+    }
+
+    // the decisions of the agents would be printed, unless they are logged
+    setenv("POMMERMAN_DECISION_LOG", "/dev/null", 0);
+    // like c_init_agent_gottingen
+    agents::GottingenAgent::Calibrate();
+
+    bench::Runner runner(options);
+    std::cout << std::left << std::setw(12) << "agent" << std::right << std::setw(8) << "turns" << std::setw(16)
+              << "sim.steps/turn" << std::setw(14) << "sim.steps/s" << std::setw(10) << "turn ms" << std::setw(10)
+              << "p99 ms" << std::setw(14) << "won/tie/lost" << std::endl;
+    if(agentName.empty() || agentName == "frankfurt")
+        Benchmark<agents::FrankfurtAgent>("frankfurt", games, seed, maxSteps, selfPlay, runner);
+    if(agentName.empty() || agentName == "gottingen")
+        Benchmark<agents::GottingenAgent>("gottingen", games, seed, maxSteps, selfPlay, runner);
+
+    return runner.Finish() ? 0 : 1;
+}
@@ -2,9 +2,17 @@
 #define RANDOM_AGENT_H
 
 #include <random>
+#include <cstdint>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include "bboard.hpp"
 #include "strategy.hpp"
+#include "hw_counters.hpp"
+#include "search_tree.hpp"
 #include <set>
 #include "uint128_t.h"
 
@@ -77,111 +85,404 @@ struct SimpleAgent : bboard::Agent
     void PrintDetailedInfo();
 };
 
-//#define DISPLAY_EXPECTATION
-//#define DISPLAY_DEPTH0_POINTS
-//#define DEBUGMODE_ON
-#ifdef DEBUGMODE_ON
-#define DEBUGMODE_STEPS //5% slower
-//#define DEBUGMODE_COMMENTS //30% slower
-#endif
+/**
+ * @brief Runs bboard::strategy::ProveKill against the visible enemies on
+ * a worker thread, while the main search of an agent is running
+ */
+struct KillSolver
+{
+    KillSolver() = default;
+    ~KillSolver();
+
+    /**
+     * @brief Available Only worth it if there are cores left next
+     * to the 6 threads of the main search
+     */
+    static bool Available();
+
+    /**
+     * @brief Start Starts solving the given state in the background
+     */
+    void Start(const bboard::State& state, int agentID, int enemy1ID, int enemy2ID);
+
+    /**
+     * @brief Finish Stops the search and waits for it
+     * @return True if a kill was proven, `move` is its first step
+     */
+    bool Finish(bboard::Move& move, int& target);
+
+    const int maxDepth = 8;
+    const int maxNodes = 200000;
+    // enemies further away (manhattan) are not worth the effort
+    const int maxDistance = 5;
+
+    int nodes = 0;
+    int provenDepth = 0;
+
+private:
+    void Run();
+
+    bboard::State state;
+    int agentID, targets[2];
+    bboard::Move provenMove;
+    int provenTarget;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool busy = false, quit = false;
+    std::atomic<bool> stop{false};
+};
 
-#ifdef DEBUGMODE_ON
-    struct StepResult
+/**
+ * @brief The DeadlineTimer struct lets the search poll the time
+ * without reading the clock. A timer thread raises the time level
+ * when the thresholds before the deadline of the turn are reached,
+ * the search only loads an atomic.
+ */
+struct DeadlineTimer
+{
+    enum TimeLevel
     {
-        float point = -100.0f;
-#ifdef DEBUGMODE_STEPS
-        bboard::FixedQueue<int, 40> steps;
-#endif
-#ifdef DEBUGMODE_COMMENTS
-        std::string comment;
-#endif
-        explicit operator float() { return point; }
+        NORMAL = 0, // every depth can go deeper
+        WRAP_UP,    // only depth < 3
+        FINISH,     // only depth < 2
+        STOP        // no deeper search (a cancellable search returns)
     };
-#else
-    typedef float StepResult;
-#endif
 
-    struct FrankfurtAgent : bboard::Agent
+    // deadline of a turn, measured from its start
+    static constexpr int defaultDeadlineMillis = 145;
+    // the time levels are raised this many milliseconds before the deadline
+    static constexpr int levelMillis[3] = {15, 5, 0};
+
+    DeadlineTimer() = default;
+    ~DeadlineTimer();
+
+    /**
+     * @brief Start Resets the level to NORMAL and raises it towards
+     * the given deadline
+     */
+    void Start(std::chrono::high_resolution_clock::time_point deadline);
+
+    /**
+     * @brief Stop Disarms the timer, the level stays where it is
+     */
+    void Stop();
+
+    inline int Level() const
     {
-        FrankfurtAgent();
+        return level.load(std::memory_order_relaxed);
+    }
 
-        bboard::Move act(const bboard::State* state) override;
+private:
+    void Run();
 
-        StepResult runAlreadyPlantedBombs(bboard::State * state);
-        StepResult runOneStep(const bboard::State * state, int depth);
-        StepResult scoreState(bboard::State * state);
-        void PrintDetailedInfo();
-        int simulatedSteps = 0;
-        int message[2];
+    std::chrono::high_resolution_clock::time_point deadline;
 
-#ifndef DEBUGMODE_STEPS
-        int depth_0_Move = 0;
-#endif
-        static bboard::FixedQueue<int, 40> moves_in_chain;
-#pragma omp threadprivate(moves_in_chain)
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool armed = false, quit = false;
+    unsigned int turn = 0;
+    std::atomic<int> level{NORMAL};
+};
 
-        static bboard::FixedQueue<bboard::Position, 40> positions_in_chain;
-#pragma omp threadprivate(positions_in_chain)
+/**
+ * @brief The DepthController struct picks the search depth and the
+ * iteration counts of the other agents for a turn, so that the search
+ * finishes in targetMillis. The speed of the search and the size of its
+ * trees come from a calibration at startup and are updated by every turn.
+ */
+struct DepthController
+{
+    // p99 turn time the controller aims at (the time levels of DeadlineTimer are the safety net)
+    static constexpr float targetMillis = 100.0f;
+    static const int minDepth = 2;
+    static const int maxDepth = 8;
+
+    // simulated steps per millisecond, 0 while unknown
+    float stepsPerMs = 0.0f;
+    // simulated steps of a finished search / Estimate, the pruning keeps the trees below the bound
+    float fill = 1.0f;
+    // scales the budget so that 1% of the turns take longer than targetMillis
+    float safety = 1.0f;
+
+    /**
+     * @brief Estimate Upper bound of the simulated steps of a search
+     * (every agent that is iterated at a depth multiplies by 6)
+     */
+    static float Estimate(int depth, int teammateIteration, int enemyIteration1, int enemyIteration2);
+
+    /**
+     * @brief Choose Adjusts the depth and the iteration counts (chosen by
+     * distance) to the step budget of the turn. Iterated agents stay iterated.
+     */
+    void Choose(int& depth, int& teammateIteration, int& enemyIteration1, int& enemyIteration2) const;
+
+    /**
+     * @brief Record Feeds back the actual speed of the search, the size of
+     * its tree (only if the search reached `depth` everywhere) and the
+     * latency of the whole turn
+     */
+    void Record(int simulatedSteps, float searchMillis, float turnMillis,
+                bool complete, int depth, int teammateIteration, int enemyIteration1, int enemyIteration2);
+};
 
-        bboard::Position expectedPosInNewTurn;
-        bool lastMoveWasBlocked = false;
-        int lastBlockedMove = 0;
-        unsigned int turns = 0;
-        unsigned int totalSimulatedSteps = 0;
-        int seenAgents = 0, iteratedAgents = 0;
-        int enemyIteration1 = 0, enemyIteration2 = 0, teammateIteration = 0, myMaxDepth = 0;
-        std::array<bboard::FixedQueue<bboard::Position, 15>, 4 > previousPositions;
-        bboard::FixedQueue<int, 15> moveHistory;
-        bool rushing = false, goingAround = false;
+/**
+ * @brief Keeps a value on its own cache line, so that threads writing
+ * neighbouring values don't slow down each other
+ */
+template <typename T>
+struct alignas(64) CacheLinePadded
+{
+    T value;
+};
+
+/**
+ * @brief Statistics of a search. Plain data, the C ABI hands it
+ * over as it is.
+ */
+struct SearchStats
+{
+    static const int MAX_DEPTH = DepthController::maxDepth;
 
+    enum Cutoff
+    {
+        DEPTH_LIMIT = 0, // leaf at myMaxDepth
+        TIME_LIMIT,      // leaf because of the time level
+        CANCELLED,       // step not simulated, the search was cancelled
+        STEP_FAILED,     // Step didn't succeed, the step is dropped
+        SCENE_VISITED,   // the same scene was already simulated (SceneHashMemory)
+        CUTOFF_COUNT
+    };
 
-        bool _CheckPos2(const bboard::State* state, bboard::Position pos, int agentId);
-        bool _CheckPos2(const bboard::State* state, int x, int y, int agentId);
-        void createDeadEndMap(const bboard::State* state);
-        float laterBetter(float reward, int timestamps);
-        float soonerBetter(float reward, int timestmaps);
-        float reward_sooner_later_ratio_pow_timestamps[30];
+    // successful Steps at each depth
+    int64_t nodes[MAX_DEPTH];
+    // simulations that ended in a rollout of the planted bombs and a scored state
+    int64_t leaves;
+    // bomb ticks simulated in the rollouts
+    int64_t rolloutTicks;
+    // own moves that surely burn (escape oracle)
+    int64_t prunedUnsafe;
+    // enemy moves skipped without a step-bomb-step cycle
+    int64_t prunedNoBombCycle;
+    int64_t cutoffs[CUTOFF_COUNT];
+    // wall time of the search
+    double searchMillis;
+    // thread time spent on the root moves and their subtrees, summed over the threads
+    // (timed at the root only, the clock reads of deeper levels would cost more than they tell)
+    double rootSubtreeMillis;
+
+    void Add(const SearchStats& other);
+    int64_t TotalNodes() const;
+};
+static_assert(std::is_standard_layout<SearchStats>::value, "SearchStats is passed through the C ABI");
 
-        const float reward_first_step_idle = 0.001f;
-        const float reward_sooner_later_ratio = 0.98f;
-        const float reward_extraBombPowerupPoints = 0.6f;
-        const float reward_extraRangePowerupPoints = 0.4f;
-        const float reward_otherKickPowerupPoints = 0.2f;
-        const float reward_firstKickPowerupPoints = 0.7f;
-        const float reward_move_to_enemy = 100.0f;
-        const float reward_move_to_pickup = 1000.0f;
-        const float reward_woodDemolished = 0.40f;
-        const float weight_of_average_Epoint = 0.1f;
+//#define DISPLAY_EXPECTATION
+//#define DISPLAY_DEPTH0_POINTS
 
-        std::set<uint128_t> visitedSteps;
-        int ourId, teammateId, enemy1Id, enemy2Id, lastSeenEnemy = 0;
-        bool leadsToDeadEnd[bboard::BOARD_SIZE*bboard::BOARD_SIZE];
-        bool sameAs6_12_turns_ago = true; // Indicates if the agent is stuck in a repeated situation
-        std::chrono::high_resolution_clock::time_point start_time;
+    typedef float StepResult;
+
+    /**
+     * @brief Reasons that contributed to the points of a scored state.
+     * They are collected as bit flags in scoreState and travel with the
+     * principal variation.
+     */
+    enum Reason
+    {
+        I_DIE           = 1 << 0,
+        TEAMMATE_DIES   = 1 << 1,
+        ENEMY1_DIES     = 1 << 2,
+        ENEMY2_DIES     = 1 << 3,
+        WOOD_DEMOLISHED = 1 << 4,
+        EXTRA_BOMB      = 1 << 5,
+        FIRST_KICK      = 1 << 6,
+        EXTRA_RANGE     = 1 << 7,
+        WE_ARE_DOWN     = 1 << 8,
+        WE_ARE_UP       = 1 << 9,
+        WE_ARE_LEFT     = 1 << 10,
+        WE_ARE_RIGHT    = 1 << 11,
+        TIE             = 1 << 12,
+        WE_LOST         = 1 << 13,
+        WE_WIN          = 1 << 14,
+        ESCAPE          = 1 << 15
+    };
+    typedef uint32_t Reasons;
+
+    /**
+     * @brief ReasonsToString Lists the names of the set flags,
+     * separated by spaces
+     */
+    std::string ReasonsToString(Reasons reasons);
+
+    /**
+     * @brief Triangular principal variation table. Row `ply` holds the
+     * best line found from `ply` on. There are 4 plies per step, one for
+     * each agent's move (own, teammate, enemy1, enemy2).
+     */
+    struct PVTable
+    {
+        // the leaves of the deepest search are at ply 4 * maxDepth
+        static const int MAX_PLY = 4 * (DepthController::maxDepth + 1);
+
+        int moves[MAX_PLY][MAX_PLY];
+        int length[MAX_PLY];
+        // reasons of the scored state at the end of the line
+        Reasons reasons[MAX_PLY];
+
+        /**
+         * @brief Leaf The line ends at `ply`
+         */
+        inline void Leaf(int ply, Reasons leafReasons = 0)
+        {
+            length[ply] = ply;
+            reasons[ply] = leafReasons;
+        }
+
+        /**
+         * @brief Update `move` is the new best move at `ply`, the line
+         * continues with the current line of ply + 1
+         */
+        inline void Update(int ply, int move)
+        {
+            moves[ply][ply] = move;
+            for (int i = ply + 1; i < length[ply + 1]; i++)
+                moves[ply][i] = moves[ply + 1][i];
+            length[ply] = length[ply + 1];
+            reasons[ply] = reasons[ply + 1];
+        }
     };
 
+    /**
+     * @brief Compile-time switches of SearchAgent. FrankfurtPolicy is the
+     * agent that is preserved as it is, GottingenPolicy is the one to
+     * develop. Switches that are off cost nothing.
+     */
+    struct FrankfurtPolicy
+    {
+        // record the principal variation and the reasons of its points
+        static constexpr bool DebugCapture = false;
+        // choose randomly between equally good moves (except BOMB), IDLE first.
+        // With nobomb-random-tiebreak: 10% less simsteps, 3% less wins :( , 5-10% less ties against simple. See log_test_02_tie.txt
+        static constexpr bool RandomTieBreak = false;
+        // don't simulate the same scene twice. 8-10x less simsteps, but 40% less wins :((
+        static constexpr bool SceneHashMemory = false;
+        // explode the already planted bombs with one call. Bit slower!
+        static constexpr bool OneCallExplosion = false;
+        // stop going deeper when the time of the turn runs out
+        static constexpr bool TimeLimit = true;
+        // don't simulate moves that surely burn, don't search forced escapes
+        static constexpr bool EscapeOracle = false;
+        // prove forced kills on spare cores next to the search
+        static constexpr bool KillSolver = false;
+        // choose the depth by the measured speed of the search instead of 6 - iterated agents
+        static constexpr bool AdaptiveDepth = false;
+    };
 
-    struct GottingenAgent : bboard::Agent
+    struct GottingenPolicy : FrankfurtPolicy
     {
-        GottingenAgent();
+        static constexpr bool DebugCapture = true;
+        static constexpr bool EscapeOracle = true;
+        static constexpr bool KillSolver = true;
+        static constexpr bool AdaptiveDepth = true;
+    };
+
+    /**
+     * @brief The search agent: simulates our moves, the teammate's
+     * (maximized) and the enemies' (minimized) moves in every combination
+     * up to myMaxDepth steps, then lets the planted bombs explode and
+     * scores the state.
+     */
+    template <typename Policy>
+    struct SearchAgent : bboard::Agent
+    {
+        SearchAgent();
 
         bboard::Move act(const bboard::State* state) override;
 
+        /**
+         * @brief act Cancellable variant: the search gives up when `cancel`
+         * is set or the deadline is reached, and returns the best root
+         * move found so far (a quick depth 1 search runs first)
+         */
+        bboard::Move act(const bboard::State* state, const std::atomic<bool>* cancel,
+                         std::chrono::high_resolution_clock::time_point deadline);
+
+        // statistics of the last act, merged from the threads
+        SearchStats stats;
+
+        // best root move of the running search, can be read from any thread.
+        // Updated whenever the subtree of a root move is searched completely.
+        std::atomic<int> bestMoveSoFar{0};
+
+        inline bool Cancelled() const
+        {
+            return cancelToken != nullptr &&
+                   (cancelToken->load(std::memory_order_relaxed) || deadline.Level() == DeadlineTimer::STOP);
+        }
+
         StepResult runAlreadyPlantedBombs(bboard::State * state);
         StepResult runOneStep(const bboard::State * state, int depth);
+        /**
+         * @brief PublishRootMove The subtree of a root move is searched
+         * completely, it becomes bestMoveSoFar if it's the best of them.
+         * The move of the quick search stays bestMoveSoFar until its own
+         * subtree is complete, then only a better move replaces it.
+         */
+        void PublishRootMove(int move, float points);
         StepResult scoreState(bboard::State * state);
         void PrintDetailedInfo();
+
+        /**
+         * @brief Calibrate Measures the speed of the search (simulated steps
+         * per millisecond) and the size of its trees on fixed benchmark
+         * positions. Only once per process.
+         */
+        static void Calibrate();
+        static float calibratedStepsPerMs;
+        // simulated steps / DepthController::Estimate of the calibration searches
+        static float calibratedFill;
+
+        static const int calibrationPositions = 3;
+        /**
+         * @brief CalibrationPosition The i-th position of the calibration
+         * (seeded board, the agents meet in the middle), agent 0 moves
+         */
+        static void CalibrationPosition(int i, bboard::State& state);
+
         int simulatedSteps = 0;
         int message[2];
+        // print the summary of every turn
+        bool verbose = true;
 
-#ifndef DEBUGMODE_STEPS
         int depth_0_Move = 0;
-#endif
-        static bboard::FixedQueue<int, 40> moves_in_chain;
-#pragma omp threadprivate(moves_in_chain)
-
-        static bboard::FixedQueue<bboard::Position, 40> positions_in_chain;
-#pragma omp threadprivate(positions_in_chain)
+        // the search state of a thread: of the OpenMP threads at the root, and of agents which play
+        // at the same time on other threads (e.g. the games of game_benchmark), also without OpenMP
+        static thread_local bboard::FixedQueue<int, 40> moves_in_chain;
+
+        static thread_local bboard::FixedQueue<bboard::Position, 40> positions_in_chain;
+
+        static thread_local PVTable pvTable;
+        // set by scoreState
+        static thread_local Reasons leafReasons;
+        // statistics of the root thread (one of perThreadStats)
+        static thread_local SearchStats* threadStats;
+        CacheLinePadded<SearchStats> perThreadStats[6];
+        // hardware counters of the last act and of the episode (if bboard::perf::Enabled())
+        bboard::perf::Sample hwCounters, totalHwCounters;
+        // the root moves of the helper threads, the calling thread is measured by act
+        CacheLinePadded<bboard::perf::Sample> perThreadHw[6];
+        // nodes of the root thread (one of treeBuffers), null unless the tree of the turn is dumped
+        static thread_local std::vector<tree::Node>* treeBuffer;
+        CacheLinePadded<std::vector<tree::Node>> treeBuffers[6];
+        bool dumpTree = false;
+        // expected line of each root move (filled by the thread of the move)
+        int rootPV[6][PVTable::MAX_PLY];
+        int rootPVLength[6];
+        Reasons rootReasons[6];
+        // expected line of the selected move, in the order own, teammate, enemy1, enemy2, own, ...
+        bboard::FixedQueue<int, PVTable::MAX_PLY> principalVariation;
+        Reasons principalReasons = 0;
 
         bboard::Position expectedPosInNewTurn;
         bool lastMoveWasBlocked = false;
@@ -195,8 +496,8 @@ struct SimpleAgent : bboard::Agent
         bool rushing = false, goingAround = false;
 
 
-        bool _CheckPos2(const bboard::State* state, bboard::Position pos, int agentId);
-        bool _CheckPos2(const bboard::State* state, int x, int y, int agentId);
+        bool _CheckPos2(const bboard::State* state, bboard::Position pos, int agentId = -1);
+        bool _CheckPos2(const bboard::State* state, int x, int y, int agentId = -1);
         void createDeadEndMap(const bboard::State* state);
         float laterBetter(float reward, int timestamps);
         float soonerBetter(float reward, int timestmaps);
@@ -218,7 +519,43 @@ struct SimpleAgent : bboard::Agent
         bool leadsToDeadEnd[bboard::BOARD_SIZE*bboard::BOARD_SIZE];
         bool sameAs6_12_turns_ago = true; // Indicates if the agent is stuck in a repeated situation
         std::chrono::high_resolution_clock::time_point start_time;
+        // off: the search goes to the full depth however long it takes (benchmarks of the search itself)
+        bool timeLimit = Policy::TimeLimit;
+        // raises the time level during the search, instead of reading the clock at every node
+        DeadlineTimer deadline;
+        // set during a cancellable act
+        const std::atomic<bool>* cancelToken = nullptr;
+        std::chrono::high_resolution_clock::time_point cancelDeadline;
+        DepthController depthController;
+
+        // points of the root moves of the last search
+        float rootPoints[6];
+        // order of the root moves, the answer of the quick search first
+        int rootOrder[6];
+        // best root move whose subtree was searched completely (-1: none yet), see PublishRootMove
+        int completedRootMove = -1;
+        float completedRootPoints = 0.0f;
+        // the root moves whose subtrees were searched completely, and their points
+        bool rootCompleted[6];
+        float rootCompletedPoints[6];
+        // the answer of the quick search (-1: none, not cancellable)
+        int quickMove = -1;
+        // threads of the root moves (1-6), and the wall time and thread of each root move of the last search
+        int rootThreads = 6;
+        double rootMoveMillis[6];
+        int rootMoveThread[6];
+        KillSolver killSolver;
+        bool useKillSolver = Policy::KillSolver && KillSolver::Available();
+        // a proven kill is only played if the main search doesn't see a disaster in it
+        const float killSolver_min_root_point = -1.0f;
     };
+
+    // defined and instantiated in search_agent.cpp
+    extern template struct SearchAgent<FrankfurtPolicy>;
+    extern template struct SearchAgent<GottingenPolicy>;
+
+    typedef SearchAgent<FrankfurtPolicy> FrankfurtAgent;
+    typedef SearchAgent<GottingenPolicy> GottingenAgent;
 }
 
 #endif
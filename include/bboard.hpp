@@ -642,7 +642,9 @@ public:
      * (blocking)
      * @param timeSteps maximum of time steps after which the game ends
      * @param render True if the game should be rendered (and played out with
-     * delay)
+     * delay). If false, the game is headless: nothing is printed, the agents
+     * have no time limit. The step listener is invoked before every step in
+     * both cases.
      * @param stepByStep For debugging purposes.If true, pauses execution
      * after each step. (Press enter to continue)
      */
@@ -0,0 +1,157 @@
+#ifndef DECISION_LOG_H
+#define DECISION_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+
+namespace bboard::log
+{
+
+/**
+ * @brief Kinds of records in the decision log
+ */
+enum RecordType : uint16_t
+{
+    TURN = 1,       // summary of a turn of a search agent
+    SAME_AS_BEFORE, // the positions are the same as 6 and 12 turns ago
+    COULDNT_MOVE,   // the agent is not where it wanted to move
+    OVERTIME,       // the search took too long
+    LEARNED,        // the state was corrected from the teammate's message
+    CALIBRATION     // the measured speed of the search (value), args: fill of the estimated tree in 1/1000
+};
+
+/**
+ * @brief Flags of a TURN record
+ */
+enum TurnFlags : uint16_t
+{
+    RUSHING      = 1 << 0,
+    GOING_AROUND = 1 << 1,
+    FORCED       = 1 << 2,
+    CANCELLED    = 1 << 3,
+    KILL         = 1 << 4, // args: target, proven depth, nodes
+    HAS_PV       = 1 << 5  // the principal variation and its reasons are printed
+};
+
+/**
+ * @brief What a LEARNED record has learned (args: item, value, previous value)
+ */
+enum LearnedItem
+{
+    MAX_BOMB_COUNT = 0,
+    TEAMMATE_CAN_KICK,
+    ENEMY1_CAN_KICK,
+    ENEMY2_CAN_KICK,
+    POSITION_X,
+    POSITION_Y,
+    BOMB_STRENGTH,
+    COME_AROUND
+};
+
+/**
+ * @brief Racing flags of a COULDNT_MOVE record (args: y, x, racing)
+ */
+enum Racing
+{
+    RACING_TEAMMATE = 1 << 0,
+    RACING_ENEMY1   = 1 << 1,
+    RACING_ENEMY2   = 1 << 2
+};
+
+/**
+ * @brief A fixed-size binary log record. The meaning of `args`
+ * depends on the type (see above).
+ */
+struct Record
+{
+    uint16_t type;
+    uint16_t flags;
+    int32_t timeStep;
+    int32_t agentID;
+    int32_t move;
+    float value;
+    int32_t simulatedSteps;
+    int32_t depth;
+    int32_t iterations[3]; // teammate, enemy1, enemy2
+    int32_t args[4];
+    uint32_t reasons;
+    int32_t pvLength;
+    int8_t pv[32];
+};
+static_assert(sizeof(Record) == 96, "The log file format depends on the record size");
+
+/**
+ * @brief Format Writes the text of a record, as the agents used to
+ * print it
+ */
+void Format(const Record& r, std::ostream& out);
+
+/**
+ * @brief The DecisionLog class is a lock-free bounded queue of records.
+ * A background thread drains it to the file given in the environment
+ * variable POMMERMAN_DECISION_LOG (binary, see tools/decode_decision_log)
+ * or, if there is none, prints them as text to stdout.
+ */
+class DecisionLog
+{
+public:
+    static const int CAPACITY = 4096;
+
+    /**
+     * @brief Get The log of the process, started on first use
+     */
+    static DecisionLog& Get();
+
+    /**
+     * @brief Push Never blocks. If the queue is full, the record is
+     * dropped and counted.
+     */
+    bool Push(const Record& r);
+
+    /**
+     * @brief Flush Waits until every pushed record is written
+     */
+    void Flush();
+
+    int64_t Dropped() const;
+
+    ~DecisionLog();
+
+private:
+    DecisionLog();
+    bool Pop(Record& r);
+    void Run();
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+    Slot slots[CAPACITY];
+
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<int64_t> dropped{0};
+    std::atomic<bool> quit{false};
+    std::thread worker;
+};
+
+/**
+ * @brief Push Shorthand for DecisionLog::Get().Push
+ */
+inline void Push(const Record& r)
+{
+    DecisionLog::Get().Push(r);
+}
+
+/**
+ * @brief The magic bytes at the start of a binary log file
+ */
+const char FILE_MAGIC[8] = {'P', 'M', 'D', 'L', 'O', 'G', '1', '\0'};
+
+}
+
+#endif // DECISION_LOG_H
@@ -0,0 +1,112 @@
+#ifndef HW_COUNTERS_H
+#define HW_COUNTERS_H
+
+#include <cstdint>
+#include <ostream>
+
+namespace bboard::perf
+{
+
+/**
+ * @brief The hardware counters read by perf_event_open (Linux only)
+ */
+enum Counter
+{
+    CYCLES = 0,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    COUNTER_COUNT
+};
+
+/**
+ * @brief Counter values. A counter that couldn't be opened stays 0.
+ */
+struct Sample
+{
+    uint64_t values[COUNTER_COUNT] = {};
+
+    Sample& operator+=(const Sample& other);
+    Sample operator-(const Sample& other) const;
+};
+
+/**
+ * @brief The HardwareCounters class counts the events of the thread
+ * that created it, in user space, from its construction on. Without
+ * permission (e.g. in a container) or support, the counters are missing
+ * and read as 0.
+ */
+class HardwareCounters
+{
+public:
+    HardwareCounters();
+    ~HardwareCounters();
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    /**
+     * @brief Available At least cycles and instructions are counted
+     */
+    bool Available() const;
+    bool Has(Counter c) const;
+
+    /**
+     * @brief Read The values since the construction
+     */
+    Sample Read() const;
+
+    /**
+     * @brief Error Why the counters are unavailable
+     */
+    const char* Error() const;
+
+private:
+    int fds[COUNTER_COUNT];
+    int error = 0;
+};
+
+/**
+ * @brief ThreadCounters The counters of the calling thread, opened
+ * on first use
+ */
+HardwareCounters& ThreadCounters();
+
+/**
+ * @brief Adds the counts of the calling thread during its lifetime
+ * to a sample (nothing if the sample is null)
+ */
+struct ScopedSample
+{
+    Sample* sum;
+    Sample begin;
+
+    explicit ScopedSample(Sample* sum) : sum(sum)
+    {
+        if(sum)
+            begin = ThreadCounters().Read();
+    }
+    ~ScopedSample()
+    {
+        if(sum)
+            *sum += ThreadCounters().Read() - begin;
+    }
+};
+
+/**
+ * @brief Enabled The agents measure their turns if the environment
+ * variable POMMERMAN_HW_COUNTERS is 1
+ */
+bool Enabled();
+
+/**
+ * @brief Report Prints IPC and the misses per simulated step
+ * @param what The name of the measured code
+ * @param steps The simulated steps in the sample
+ */
+void Report(std::ostream& out, const char* what, const Sample& sample, int64_t steps);
+
+}
+
+#endif // HW_COUNTERS_H
@@ -0,0 +1,97 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+
+namespace bboard::metrics
+{
+
+/**
+ * Process-wide metrics of the agents, for long running processes.
+ * They are updated once per turn with relaxed atomics (no locks).
+ *
+ * If the environment variable POMMERMAN_METRICS_FILE is set, a
+ * background thread rewrites that file in the Prometheus text format
+ * every POMMERMAN_METRICS_INTERVAL_MS milliseconds (default 5000),
+ * e.g. for the textfile collector of the node exporter.
+ */
+
+class Counter
+{
+public:
+    void Add(uint64_t n = 1)
+    {
+        value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t Value() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+/**
+ * @brief A Histogram counts the observed values in buckets with
+ * fixed upper bounds
+ */
+class Histogram
+{
+public:
+    static const int MAX_BOUNDS = 16;
+
+    Histogram(std::initializer_list<double> upperBounds);
+
+    void Observe(double value);
+
+    /**
+     * @brief Write Writes the buckets, the sum and the count in
+     * the Prometheus text format
+     */
+    void Write(std::ostream& out, const char* name) const;
+
+private:
+    double bounds[MAX_BOUNDS];
+    int boundCount = 0;
+    // the last one is +Inf
+    std::atomic<uint64_t> buckets[MAX_BOUNDS + 1] = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<double> sum{0.0};
+};
+
+/**
+ * @brief The metrics of all search agents of the process
+ */
+struct AgentMetrics
+{
+    Counter turns;
+    Counter overtimes;
+    Counter nodes;
+    Counter rollouts;
+    Counter rolloutTicks;
+    // the scene hash memory: a lookup for every node, a hit is a skipped scene
+    Counter sceneLookups;
+    Counter sceneHits;
+
+    Histogram turnSeconds{0.01, 0.025, 0.05, 0.075, 0.1, 0.125, 0.14, 0.15, 0.2, 0.5};
+    Histogram nodesPerSecond{1e4, 3e4, 1e5, 3e5, 1e6, 3e6, 1e7};
+    Histogram depth{1, 2, 3, 4, 5, 6, 7, 8};
+};
+
+/**
+ * @brief Agents The metrics of the process, the exporter is started on first use
+ */
+AgentMetrics& Agents();
+
+/**
+ * @brief Write Writes all metrics in the Prometheus text format
+ */
+void Write(std::ostream& out);
+
+}
+
+#endif // METRICS_H
@@ -0,0 +1,90 @@
+#ifndef SEARCH_TREE_H
+#define SEARCH_TREE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace agents::tree
+{
+
+/**
+ * The search tree of a turn can be dumped to a binary file for offline
+ * analysis (tools/analyze_search_tree). It is switched on by environment
+ * variables:
+ *  - POMMERMAN_TREE_DUMP=<prefix>: the files are <prefix>.agent<id>.turn<t>.tree
+ *  - POMMERMAN_TREE_DUMP_TURN=<t>: only that turn is dumped (default: all)
+ *
+ * The file is a Header followed by the Nodes in post-order: the children
+ * of a node at depth d are the nodes at depth d+1 right before it, in the
+ * order the search visited them. The nodes at depth 0 are the children
+ * of the root.
+ */
+
+enum NodeFlags : uint8_t
+{
+    LEAF        = 1 << 0, // scored after a rollout of the planted bombs
+    TIME_CUTOFF = 1 << 1  // a leaf because of the time limit, not the depth
+};
+
+/**
+ * @brief A simulated step of the search
+ */
+struct Node
+{
+    // what the step returned to its parent (score of the leaf or the best of the children)
+    float value;
+    // successful Steps in the subtree, including this one
+    int32_t subtreeNodes;
+    // bomb ticks simulated in the rollouts of the subtree
+    int32_t rolloutTicks;
+    uint8_t depth;
+    uint8_t flags;
+    // the joint move: own, teammate, enemy1, enemy2
+    uint8_t moves[4];
+    // distinct moves of the agents among the children (filled when written)
+    uint8_t legalMoves[4];
+    uint8_t padding[2];
+};
+static_assert(sizeof(Node) == 24, "The tree file format depends on the node size");
+
+const char FILE_MAGIC[8] = {'P', 'M', 'T', 'R', 'E', 'E', '1', '\0'};
+
+/**
+ * @brief The turn the tree belongs to
+ */
+struct Header
+{
+    char magic[8];
+    int32_t timeStep;
+    int32_t agentId;
+    int32_t chosenMove;
+    int32_t maxDepth;
+    int32_t iterations[3]; // teammate, enemy1, enemy2
+    // the weight of the average enemy reply in the values (weight_of_average_Epoint)
+    float averageWeight;
+    // value of each root move, -10000 if it wasn't searched
+    float rootPoints[6];
+    int32_t nodeCount;
+};
+
+/**
+ * @brief DumpPath The file for the tree of the turn or an empty string,
+ * if it isn't dumped
+ */
+std::string DumpPath(int agentId, int timeStep);
+
+/**
+ * @brief Write Writes the nodes of the threads one after the other
+ * (a root move is searched by one thread, its subtree is contiguous)
+ */
+bool Write(const std::string& path, Header header, std::vector<Node>* buffers, int bufferCount);
+
+/**
+ * @brief Read Reads a tree file, false if it isn't one
+ */
+bool Read(const std::string& path, Header& header, std::vector<Node>& nodes);
+
+}
+
+#endif // SEARCH_TREE_H
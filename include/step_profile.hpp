@@ -0,0 +1,125 @@
+#ifndef STEP_PROFILE_H
+#define STEP_PROFILE_H
+
+#include <cstdint>
+#include <ostream>
+
+#ifdef STEP_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace bboard::profile
+{
+
+/**
+ * @brief The phases of bboard::Step. The chain reversion is
+ * measured inside BOMB_STOPS.
+ */
+enum Phase
+{
+    STEP = 0,
+    TICK_FLAMES,
+    DESTINATIONS,     // FillPositions, FillDestPos, FixSwitchMove
+    DEPENDENCIES,     // ResolveDependencies
+    AGENT_MOVES,
+    BOMB_STOPS,       // bombs blocked by agents and obstacles
+    CHAIN_REVERSION,  // AgentBombChainReversion
+    BOMB_MOVES,
+    EXPLOSIONS,       // TickBombs
+    PHASE_COUNT
+};
+
+/**
+ * @brief Rare events in bboard::Step, counted
+ */
+enum Event
+{
+    OUROBOROS = 0,
+    KICK,
+    BOMB_COLLISION,
+    BOMB_INTO_FLAME,
+    EVENT_COUNT
+};
+
+/**
+ * @brief The counters of a thread
+ */
+struct Counters
+{
+    uint64_t calls[PHASE_COUNT];
+    uint64_t cycles[PHASE_COUNT];
+    uint64_t events[EVENT_COUNT];
+};
+
+/**
+ * @brief ThreadCounters The counters of the calling thread
+ */
+Counters& ThreadCounters();
+
+/**
+ * @brief Report Prints the sum of the counters of all threads. Only
+ * call it while no thread is stepping.
+ */
+void Report(std::ostream& out);
+
+/**
+ * @brief Reset Zeroes the counters of all threads
+ */
+void Reset();
+
+#ifdef STEP_PROFILE
+
+inline uint64_t Cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    // no cycle counter, nanoseconds instead
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Adds the cycles of its lifetime to a phase
+ */
+struct ScopedPhase
+{
+    Phase phase;
+    uint64_t begin;
+
+    explicit ScopedPhase(Phase p) : phase(p), begin(Cycles()) {}
+    ~ScopedPhase()
+    {
+        Counters& c = ThreadCounters();
+        c.calls[phase]++;
+        c.cycles[phase] += Cycles() - begin;
+    }
+};
+
+#define STEP_PROFILE_SCOPE(phase) bboard::profile::ScopedPhase stepProfile_##phase(bboard::profile::phase)
+#define STEP_PROFILE_BEGIN(phase) const uint64_t stepProfile_##phase = bboard::profile::Cycles()
+#define STEP_PROFILE_END(phase) \
+    do { \
+        bboard::profile::Counters& stepProfileCounters = bboard::profile::ThreadCounters(); \
+        stepProfileCounters.calls[bboard::profile::phase]++; \
+        stepProfileCounters.cycles[bboard::profile::phase] += bboard::profile::Cycles() - stepProfile_##phase; \
+    } while(0)
+#define STEP_PROFILE_EVENT(event) bboard::profile::ThreadCounters().events[bboard::profile::event]++
+
+#else
+
+#define STEP_PROFILE_SCOPE(phase)
+#define STEP_PROFILE_BEGIN(phase)
+#define STEP_PROFILE_END(phase)
+#define STEP_PROFILE_EVENT(event) do {} while(0)
+
+#endif
+
+}
+
+#endif // STEP_PROFILE_H
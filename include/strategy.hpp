@@ -1,6 +1,8 @@
 #ifndef STRATEGY_H
 #define STRATEGY_H
 
+#include <atomic>
+
 #include "bboard.hpp"
 #include "step_utility.hpp"
 
@@ -172,6 +174,90 @@ inline bool IsInBombRange(int x, int y, int s, const Position& pos)
 }
 
 
+///////////////////
+// Escape Oracle //
+///////////////////
+
+/**
+ * @brief FLAME_HORIZON After this many steps every bomb that is
+ * currently on the board (or planted in the current step) has
+ * exploded and all of its flames are gone.
+ */
+const int FLAME_HORIZON = BOMB_LIFETIME + 1 + FLAME_LIFETIME;
+
+/**
+ * @brief FlameTicks Bitmask over steps, bit t stands for the board
+ * after t steps.
+ */
+typedef uint16_t FlameTicks;
+static_assert (FLAME_HORIZON < 16, "Flame schedule must fit into 16 bits");
+
+/**
+ * @brief The FlameSchedule struct is the precomputed future of all
+ * bombs and flames of a state, assuming that no new bombs get planted
+ * and nobody kicks. For every cell it holds the steps at which
+ * the cell burns, is blocked by wood/walls or holds a bomb.
+ */
+struct FlameSchedule
+{
+    FlameTicks burning[BOARD_SIZE][BOARD_SIZE];
+    FlameTicks blocked[BOARD_SIZE][BOARD_SIZE];
+    FlameTicks bombs[BOARD_SIZE][BOARD_SIZE];
+
+    // the last step that still has bombs or flames on the board
+    int horizon;
+};
+
+/**
+ * @brief FillFlameSchedule Simulates the bombs and flames of the given
+ * state until all of them are gone and records the schedule.
+ */
+void FillFlameSchedule(const State& s, FlameSchedule& fs);
+
+/**
+ * @brief CanEscape BFS over (cell, step) pairs. Returns true if an agent
+ * that stands at (x, y) after `tick` steps can reach a cell that never
+ * burns again. Other agents are considered to be walkable, bombs only
+ * if the agent can kick.
+ */
+bool CanEscape(const FlameSchedule& fs, int x, int y, int tick, bool canKick);
+
+/**
+ * @brief SafeMoves Marks every move (IDLE..BOMB) that is legal for the
+ * agent and still leaves an escape path from the bombs and flames
+ * already on the board. A kick is always safe, the bombs are predicted
+ * as if nobody kicks them.
+ * @param safe Array of 6 flags, indexed by Move
+ * @return The number of safe moves
+ */
+int SafeMoves(const State& state, int agentID, bool safe[6]);
+
+/**
+ * @brief ForcedEscapeMove If exactly one move of the agent escapes from
+ * the bombs and flames on the board, returns true and sets `move`.
+ * A kick is never forced.
+ */
+bool ForcedEscapeMove(const State& state, int agentID, Move& move);
+
+/////////////////
+// Kill Solver //
+/////////////////
+
+/**
+ * @brief ProveKill Searches for a forced kill: a sequence of bomb, kick
+ * and approaching moves of `agentID` after which `targetID` is dead or
+ * has no escape left (see SafeMoves), whatever the target does. All other
+ * agents are assumed to stand still. Iterative deepening up to `maxDepth`
+ * steps.
+ * @param stop The search gives up as soon as this is set (may be null)
+ * @param nodes Incremented for every searched node, the search gives up
+ * after `maxNodes`
+ * @return The length of the proven kill (and sets `move` to its first
+ * move), 0 if no kill was found
+ */
+int ProveKill(const State& state, int agentID, int targetID, int maxDepth, Move& move,
+              const std::atomic<bool>* stop, int& nodes, int maxNodes);
+
 /**
  * @brief PrintMap Pretty-prints the reachable map
  */
@@ -0,0 +1,106 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace bboard::trace
+{
+
+/**
+ * The trace is a timeline of named spans, written as Chrome trace-event
+ * JSON (load it in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * It is switched on by environment variables:
+ *  - POMMERMAN_TRACE=<prefix>: the files are <prefix>.agent<id>.turn<t>.json
+ *    or, with POMMERMAN_TRACE_EPISODE=1, <prefix>.agent<id>.episode<e>.json
+ *  - POMMERMAN_TRACE_LEVEL=2 also records every rollout (default 1)
+ *
+ * While it is off, a span costs one relaxed atomic load.
+ */
+
+/**
+ * @brief The detail of the recorded spans, 0 means off
+ */
+extern std::atomic<int> level;
+
+/**
+ * @brief Now Nanoseconds since the start of the process
+ */
+int64_t Now();
+
+/**
+ * @brief Record Adds a finished span to the buffer of the calling thread,
+ * with the agent of the thread
+ */
+void Record(const char* name, int64_t begin, int64_t end, int arg);
+
+/**
+ * @brief SetAgent The agent of the spans which the calling thread records
+ * from now on (-1 for none). Several agents of a process can search at the
+ * same time, every thread which works for one of them names it.
+ */
+void SetAgent(int agentId);
+
+/**
+ * @brief A Span records the time between its construction and its
+ * destruction. The name must be a string literal. A span without
+ * a name or with a higher detail than the trace level is skipped.
+ */
+class Span
+{
+public:
+    explicit Span(const char* name, int arg = -1, int detail = 1)
+    {
+        if(name && detail <= level.load(std::memory_order_relaxed))
+        {
+            this->name = name;
+            this->arg = arg;
+            begin = Now();
+        }
+    }
+
+    ~Span()
+    {
+        if(name)
+            Record(name, begin, Now(), arg);
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name = nullptr;
+    int arg = -1;
+    int64_t begin = 0;
+};
+
+/**
+ * @brief Configure Switches the trace on (level > 0) or off, instead
+ * of the environment variables
+ */
+void Configure(int level, const std::string& prefix, bool perEpisode);
+
+/**
+ * @brief EndTurn Collects the spans which the agent recorded since its
+ * last turn (and the ones of no agent), the spans of the other agents stay.
+ * Writes them in a file, unless they are kept for the episode.
+ */
+void EndTurn(int agentId, int timeStep);
+
+/**
+ * @brief EndEpisode Writes the kept spans of the agent in a file
+ */
+void EndEpisode(int agentId);
+
+/**
+ * @brief TakeTotals Sums the durations (ns) of the kept spans of the
+ * agent by their names and drops the spans, instead of EndEpisode
+ */
+std::map<std::string, int64_t> TakeTotals(int agentId);
+
+}
+
+#endif // TRACE_H
@@ -1,12 +1,53 @@
 #! /bin/sh
-make -s main
-make -s test
+if [ "$1" = "-b" ] || [ "$1" = "-B" ]; then
+	# the benchmarks compared with the committed baseline of this machine
+	# class (-B records it), e.g. ./performance.sh -b 5 fails if something
+	# got more than 5% slower
+	CLASS=${POMMERMAN_MACHINE_CLASS:-$(grep -m1 "model name" /proc/cpuinfo | sed 's/.*: //' | tr -cs 'A-Za-z0-9' '_' | sed 's/_$//')_$(nproc)cpu}
+	BASELINE=benchmark/baselines/$CLASS
+	make -s main
+	make -s bench
+	if [ "$1" = "-B" ]; then
+		mkdir -p $BASELINE
+		./bin/micro_benchmark --out $BASELINE/micro.tsv && ./bin/latency_benchmark --out $BASELINE/latency.tsv && ./bin/search_benchmark --out $BASELINE/search.tsv
+		echo "Recorded the baseline $BASELINE, commit it"
+		exit
+	fi
+	if [ ! -d $BASELINE ]; then
+		echo "No baseline for $CLASS, record it with -B (or set POMMERMAN_MACHINE_CLASS)"
+		exit 1
+	fi
+	TOLERANCE=${2:-10}
+	./bin/micro_benchmark --baseline $BASELINE/micro.tsv --tolerance $TOLERANCE
+	MICRO=$?
+	./bin/latency_benchmark --baseline $BASELINE/latency.tsv --tolerance $TOLERANCE
+	LATENCY=$?
+	./bin/search_benchmark --baseline $BASELINE/search.tsv --tolerance $TOLERANCE
+	SEARCH=$?
+	[ $MICRO -eq 0 ] && [ $LATENCY -eq 0 ] && [ $SEARCH -eq 0 ]
+	exit
+fi
+if [ "$1" = "-p" ]; then
+	# the objects don't depend on the flags, so everything is rebuilt with
+	# the Step profile and then without it
+	shift
+	make -s clean
+	make -s main DEFS=-DSTEP_PROFILE
+	make -s test DEFS=-DSTEP_PROFILE
+	PROFILED=1
+else
+	make -s main
+	make -s test
+fi
 if [ "$#" -eq 0 ]; then
 	(cd bin/ && ./test "[performance]")
 else
 	if [ "$1" = "-t" ]; then
 		(cd bin/ && ./test "[performance]" --threads $2)
 	else
-		echo "Didn't recognize argument. Use -t x for concurrent testing."
+		echo "Didn't recognize argument. Use -t x for concurrent testing, -p for the Step profile, -b [%] to compare with the baseline."
 	fi
 fi
+if [ -n "$PROFILED" ]; then
+	make -s clean
+fi
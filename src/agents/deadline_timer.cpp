@@ -0,0 +1,72 @@
+#include "agents.hpp"
+
+namespace agents
+{
+
+constexpr int DeadlineTimer::defaultDeadlineMillis;
+constexpr int DeadlineTimer::levelMillis[3];
+
+DeadlineTimer::~DeadlineTimer()
+{
+    if(worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+}
+
+void DeadlineTimer::Start(std::chrono::high_resolution_clock::time_point deadline)
+{
+    if(!worker.joinable())
+    {
+        worker = std::thread(&DeadlineTimer::Run, this);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    this->deadline = deadline;
+    level.store(NORMAL, std::memory_order_relaxed);
+    armed = true;
+    turn++;
+    cv.notify_all();
+}
+
+void DeadlineTimer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        armed = false;
+        turn++;
+    }
+    cv.notify_all();
+}
+
+void DeadlineTimer::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned int seen = 0;
+    // every Start/Stop is a new turn, an older one is abandoned
+    auto changed = [&]{ return turn != seen || quit; };
+    while(true)
+    {
+        cv.wait(lock, changed);
+        if(quit)
+            return;
+        seen = turn;
+        if(!armed)
+            continue;
+
+        for(int l = WRAP_UP; l <= STOP; l++)
+        {
+            auto until = deadline - std::chrono::milliseconds(levelMillis[l - 1]);
+            if(cv.wait_until(lock, until, changed))
+                break;
+            level.store(l, std::memory_order_relaxed);
+        }
+    }
+}
+
+}
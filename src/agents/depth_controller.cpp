@@ -0,0 +1,79 @@
+#include "agents.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace agents
+{
+
+constexpr float DepthController::targetMillis;
+
+float DepthController::Estimate(int depth, int teammateIteration, int enemyIteration1, int enemyIteration2)
+{
+    float total = 0.0f;
+    float level = 1.0f;
+    for(int d = 0; d < depth; d++)
+    {
+        level *= 6.0f * (d < teammateIteration ? 6 : 1) * (d < enemyIteration1 ? 6 : 1)
+                 * (d < enemyIteration2 ? 6 : 1);
+        total += level;
+    }
+    return total;
+}
+
+void DepthController::Choose(int& depth, int& teammateIteration, int& enemyIteration1, int& enemyIteration2) const
+{
+    if(stepsPerMs <= 0.0f)
+        return;
+
+    const float budget = stepsPerMs * targetMillis * safety;
+    auto estimate = [&](int d)
+    {
+        return fill * Estimate(d, teammateIteration, enemyIteration1, enemyIteration2);
+    };
+
+    while(depth > minDepth && estimate(depth) > budget)
+        depth--;
+
+    // still too slow: the agent iterated the longest is iterated less
+    while(estimate(depth) > budget)
+    {
+        int* longest = &teammateIteration;
+        if(enemyIteration1 > *longest) longest = &enemyIteration1;
+        if(enemyIteration2 > *longest) longest = &enemyIteration2;
+        if(*longest <= 1)
+            break;
+        (*longest)--;
+    }
+
+    while(depth < maxDepth && estimate(depth + 1) <= budget)
+        depth++;
+}
+
+void DepthController::Record(int simulatedSteps, float searchMillis, float turnMillis,
+                             bool complete, int depth, int teammateIteration, int enemyIteration1, int enemyIteration2)
+{
+    if(simulatedSteps > 0 && searchMillis > 1.0f)
+    {
+        const float observed = simulatedSteps / searchMillis;
+        stepsPerMs = stepsPerMs <= 0.0f ? observed : 0.8f * stepsPerMs + 0.2f * observed;
+    }
+
+    // a search cut by the time levels says nothing about the size of the tree
+    if(complete && simulatedSteps > 0)
+    {
+        const float observed = simulatedSteps / Estimate(depth, teammateIteration, enemyIteration1, enemyIteration2);
+        fill = std::min(1.0f, 0.8f * fill + 0.2f * observed);
+    }
+
+    // Quantile tracking: a slow turn costs as much budget as 99 fast turns
+    // win back, so the budget settles where 1% of the turns are slower than
+    // targetMillis. It also corrects what fill doesn't (e.g. trees that grow
+    // faster with the depth than the fitted fill says).
+    if(turnMillis > targetMillis)
+        safety = std::max(0.1f, safety * std::exp(-0.99f * 0.5f));
+    else
+        safety = std::min(4.0f, safety * std::exp(0.01f * 0.5f));
+}
+
+}
@@ -0,0 +1,107 @@
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "strategy.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+KillSolver::~KillSolver()
+{
+    if(worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+            stop = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+}
+
+bool KillSolver::Available()
+{
+    return std::thread::hardware_concurrency() > 6;
+}
+
+void KillSolver::Start(const State& state, int agentID, int enemy1ID, int enemy2ID)
+{
+    if(!worker.joinable())
+    {
+        worker = std::thread(&KillSolver::Run, this);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    this->state = state;
+    this->agentID = agentID;
+
+    // closer enemy first
+    const AgentInfo& a = state.agents[agentID];
+    auto distance = [&](int id)
+    {
+        const AgentInfo& e = state.agents[id];
+        return e.dead || e.x < 0 ? 100 : std::abs(e.x - a.x) + std::abs(e.y - a.y);
+    };
+    const bool swap = distance(enemy2ID) < distance(enemy1ID);
+    targets[0] = swap ? enemy2ID : enemy1ID;
+    targets[1] = swap ? enemy1ID : enemy2ID;
+    for(int i = 0; i < 2; i++)
+    {
+        if(distance(targets[i]) > maxDistance)
+            targets[i] = -1;
+    }
+
+    nodes = 0;
+    provenDepth = 0;
+    stop = false;
+    busy = true;
+    cv.notify_all();
+}
+
+bool KillSolver::Finish(Move& move, int& target)
+{
+    stop = true;
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this]{ return !busy; });
+
+    if(provenDepth == 0)
+        return false;
+
+    move = provenMove;
+    target = provenTarget;
+    return true;
+}
+
+void KillSolver::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        cv.wait(lock, [this]{ return busy || quit; });
+        if(quit)
+            return;
+
+        lock.unlock();
+        int depth = 0;
+        Move move = Move::IDLE;
+        int target = -1;
+        for(int i = 0; i < 2 && depth == 0 && !stop; i++)
+        {
+            if(targets[i] < 0)
+                continue;
+            depth = strategy::ProveKill(state, agentID, targets[i], maxDepth, move, &stop, nodes, maxNodes);
+            target = targets[i];
+        }
+        lock.lock();
+
+        provenDepth = depth;
+        provenMove = move;
+        provenTarget = target;
+        busy = false;
+        cv.notify_all();
+    }
+}
+
+}
@@ -2,31 +2,84 @@
 #include "agents.hpp"
 #include "strategy.hpp"
 #include "step_utility.hpp"
-#include <list>
+#include "decision_log.hpp"
+#include "trace.hpp"
+#include "metrics.hpp"
 #include <cstring>
 #include <omp.h>
 
 using namespace bboard;
 using namespace bboard::strategy;
 
-bboard::FixedQueue<int, 40> agents::GottingenAgent::moves_in_chain;
-bboard::FixedQueue<bboard::Position, 40> agents::GottingenAgent::positions_in_chain;
+template <typename Policy>
+thread_local bboard::FixedQueue<int, 40> agents::SearchAgent<Policy>::moves_in_chain;
+template <typename Policy>
+thread_local bboard::FixedQueue<bboard::Position, 40> agents::SearchAgent<Policy>::positions_in_chain;
+template <typename Policy>
+thread_local agents::PVTable agents::SearchAgent<Policy>::pvTable;
+template <typename Policy>
+thread_local agents::Reasons agents::SearchAgent<Policy>::leafReasons;
+template <typename Policy>
+thread_local agents::SearchStats* agents::SearchAgent<Policy>::threadStats;
+template <typename Policy>
+thread_local std::vector<agents::tree::Node>* agents::SearchAgent<Policy>::treeBuffer;
+template <typename Policy>
+float agents::SearchAgent<Policy>::calibratedStepsPerMs = 0.0f;
+template <typename Policy>
+float agents::SearchAgent<Policy>::calibratedFill = 1.0f;
 
 namespace agents {
-	GottingenAgent::GottingenAgent() {
+	std::string ReasonsToString(Reasons reasons) {
+		static const char * names[] = {"I_die", "teammate_dies", "enemy1_dies", "enemy2_dies", "woodDemolished",
+			"extraBombPowerupPoints", "firstKickPowerupPoints", "extraRangePowerupPoints",
+			"weAreDown", "weAreUp", "weAreLeft", "weAreRight", "tie", "we_lost", "we_win", "escape"};
+		std::string result;
+		for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+			if (reasons & (1u << i)) {
+				result += names[i];
+				result += " ";
+			}
+		return result;
+	}
+
+	void SearchStats::Add(const SearchStats& other) {
+		for (int i = 0; i < MAX_DEPTH; i++)
+			nodes[i] += other.nodes[i];
+		searchMillis += other.searchMillis;
+		rootSubtreeMillis += other.rootSubtreeMillis;
+		leaves += other.leaves;
+		rolloutTicks += other.rolloutTicks;
+		prunedUnsafe += other.prunedUnsafe;
+		prunedNoBombCycle += other.prunedNoBombCycle;
+		for (int i = 0; i < CUTOFF_COUNT; i++)
+			cutoffs[i] += other.cutoffs[i];
+	}
+
+	int64_t SearchStats::TotalNodes() const {
+		int64_t total = 0;
+		for (int i = 0; i < MAX_DEPTH; i++)
+			total += nodes[i];
+		return total;
+	}
+
+	template <typename Policy>
+	SearchAgent<Policy>::SearchAgent() {
 	    for(int timestap=0; timestap<30; timestap++)
         reward_sooner_later_ratio_pow_timestamps[timestap] = (float)std::pow(reward_sooner_later_ratio, timestap);
 	}
 
-	bool GottingenAgent::_CheckPos2(const State *state, bboard::Position pos, int agentId = -1) {
+	template <typename Policy>
+	bool SearchAgent<Policy>::_CheckPos2(const State *state, bboard::Position pos, int agentId) {
 		return _CheckPos2(state, pos.x, pos.y, agentId);
 	}
 
-	bool GottingenAgent::_CheckPos2(const State *state, int x, int y, int agentId = -1) {
+	template <typename Policy>
+	bool SearchAgent<Policy>::_CheckPos2(const State *state, int x, int y, int agentId) {
 		return !util::IsOutOfBounds(x, y) && (IS_WALKABLE_OR_AGENT(state->board[y][x]) || (agentId >= 0 && state->agents[agentId].canKick && state->board[y][x] == BOMB));
 	}
 
-	float GottingenAgent::laterBetter(float reward, int timestaps) {
+	template <typename Policy>
+	float SearchAgent<Policy>::laterBetter(float reward, int timestaps) {
 		if (reward == 0.0f)
 			return reward;
 
@@ -36,7 +89,8 @@ namespace agents {
 			return reward * reward_sooner_later_ratio_pow_timestamps[timestaps];
 	}
 
-	float GottingenAgent::soonerBetter(float reward, int timestaps) {
+	template <typename Policy>
+	float SearchAgent<Policy>::soonerBetter(float reward, int timestaps) {
 		if (reward == 0.0f)
 			return reward;
 
@@ -46,39 +100,31 @@ namespace agents {
 			return reward * reward_sooner_later_ratio_pow_timestamps[timestaps];
 	}
 
-	StepResult GottingenAgent::scoreState(State *state) {
+	template <typename Policy>
+	StepResult SearchAgent<Policy>::scoreState(State *state) {
 		StepResult stepRes;
+		Reasons reasons = 0;
 		float teamBalance = (ourId < 2 ? 1.01f : 0.99f);
 		float point = 0.0f;
 		if (state->agents[ourId].dead) {
 			point += laterBetter(-10 * state->agents[ourId].dead, state->agents[ourId].diedAt - state->timeStep);
-#ifdef DEBUGMODE_COMMENTS
-			stepRes.comment += "I_die ";
-#endif
+			reasons |= I_DIE;
 		}
 		if (state->agents[teammateId].x >= 0 && state->agents[teammateId].dead) {
 			point += laterBetter(-10 * state->agents[teammateId].dead, state->agents[teammateId].diedAt - state->timeStep);
-#ifdef DEBUGMODE_COMMENTS
-			stepRes.comment += "teammate_dies ";
-#endif
+			reasons |= TEAMMATE_DIES;
 		}
 		if (state->agents[enemy1Id].x >= 0 && state->agents[enemy1Id].dead) {
 			point += 3 * soonerBetter(state->agents[enemy1Id].dead, state->agents[enemy1Id].diedAt - state->timeStep);
-#ifdef DEBUGMODE_COMMENTS
-			stepRes.comment += "enemy1_dies ";
-#endif
+			reasons |= ENEMY1_DIES;
 		}
 		if (state->agents[enemy2Id].x >= 0 && state->agents[enemy2Id].dead) {
 			point += 3 * soonerBetter(state->agents[enemy2Id].dead, state->agents[enemy2Id].diedAt - state->timeStep);
-#ifdef DEBUGMODE_COMMENTS
-			stepRes.comment += "enemy2_dies ";
-#endif
+			reasons |= ENEMY2_DIES;
 		}
 
-#ifdef DEBUGMODE_COMMENTS
 		if (state->agents[ourId].woodDemolished > 0)
-			stepRes.comment += "woodDemolished ";
-#endif
+			reasons |= WOOD_DEMOLISHED;
 		point += reward_woodDemolished * state->agents[ourId].woodDemolished;
 		point += reward_woodDemolished * state->agents[teammateId].woodDemolished;
 		point -= reward_woodDemolished * state->agents[enemy1Id].woodDemolished;
@@ -89,14 +135,12 @@ namespace agents {
 		if(state->longestChainedBombDistance > 1 && (state->agents[teammateId].x < 0 || (state->agents[enemy1Id].x >= 0 && state->agents[enemy2Id].x >= 0)))
 		    point += ((float)state->longestChainedBombDistance) / 200.0f;
 
-#ifdef DEBUGMODE_COMMENTS
         if (state->agents[ourId].extraBombPowerupPoints > 0)
-            stepRes.comment += "extraBombPowerupPoints ";
+            reasons |= EXTRA_BOMB;
         if (state->agents[ourId].firstKickPowerupPoints > 0)
-            stepRes.comment += "firstKickPowerupPoints ";
+            reasons |= FIRST_KICK;
         if (state->agents[ourId].extraRangePowerupPoints > 0)
-            stepRes.comment += "extraRangePowerupPoints ";
-#endif
+            reasons |= EXTRA_RANGE;
         point += (reward_extraBombPowerupPoints * state->agents[state->ourId].extraBombPowerupPoints +    reward_firstKickPowerupPoints * state->agents[state->ourId].firstKickPowerupPoints + reward_otherKickPowerupPoints * state->agents[state->ourId].otherKickPowerupPoints + reward_extraRangePowerupPoints * state->agents[state->ourId].extraRangePowerupPoints) * teamBalance;
         point += (reward_extraBombPowerupPoints * state->agents[state->teammateId].extraBombPowerupPoints + reward_firstKickPowerupPoints * state->agents[state->teammateId].firstKickPowerupPoints + reward_otherKickPowerupPoints * state->agents[state->teammateId].otherKickPowerupPoints + reward_extraRangePowerupPoints * state->agents[state->teammateId].extraRangePowerupPoints) / teamBalance;
         point -= reward_extraBombPowerupPoints * state->agents[state->enemy1Id].extraBombPowerupPoints + reward_firstKickPowerupPoints * state->agents[state->enemy1Id].firstKickPowerupPoints + reward_otherKickPowerupPoints * state->agents[state->enemy1Id].otherKickPowerupPoints + reward_extraRangePowerupPoints * state->agents[state->enemy1Id].extraRangePowerupPoints;
@@ -129,16 +173,14 @@ namespace agents {
 			bool weAreUp = previousPositions[ourId][previousPositions[ourId].count - 1].y < 3;
 			bool weAreRight = previousPositions[ourId][previousPositions[ourId].count - 1].x >= BOARD_SIZE - 3;
 			bool weAreLeft = previousPositions[ourId][previousPositions[ourId].count - 1].x < 3;
-#ifdef DEBUGMODE_COMMENTS
 			if (weAreDown)
-				stepRes.comment += "weAreDown ";
+				reasons |= WE_ARE_DOWN;
 			if (weAreUp)
-				stepRes.comment += "weAreUp ";
+				reasons |= WE_ARE_UP;
 			if (weAreLeft)
-				stepRes.comment += "weAreLeft ";
+				reasons |= WE_ARE_LEFT;
 			if (weAreRight)
-				stepRes.comment += "weAreRight ";
-#endif
+				reasons |= WE_ARE_RIGHT;
 			if (weAreDown || weAreUp)
 			{
 				//Moving horizontally
@@ -198,32 +240,24 @@ namespace agents {
 
 		if (state->aliveAgents == 0) {
 			//point += soonerBetter(??, state->relTimeStep); //we win
-#ifdef DEBUGMODE_COMMENTS
-			stepRes.comment += "tie ";
-#endif
+			reasons |= TIE;
 		}
 		else if (state->aliveAgents < 3) {
 			if (state->agents[ourId].dead && state->agents[teammateId].dead) {
 				point += laterBetter(-20.0f, state->relTimeStep); //we lost
-#ifdef DEBUGMODE_COMMENTS
-				stepRes.comment += "we_lost ";
-#endif
+				reasons |= WE_LOST;
 			}
 			if (state->agents[enemy1Id].dead && state->agents[enemy2Id].dead) {
 				point += soonerBetter(+20.0f, state->relTimeStep); //we win
-#ifdef DEBUGMODE_COMMENTS
-				stepRes.comment += "we_win ";
-#endif
+				reasons |= WE_WIN;
 			}
 		}
 
         // Run away -> maximalize distance from enemies, try to have a tie
         // if 3 agents alive, only teammate is dead, but both enemies are within range
 		bool move_away_from_enemy =  state->aliveAgents == 3 && state->agents[teammateId].dead && state->agents[enemy1Id].x >= 0 && state->agents[enemy2Id].x >= 0;
-#ifdef DEBUGMODE_COMMENTS
         if(move_away_from_enemy)
-            stepRes.comment += "escape ";
-#endif
+            reasons |= ESCAPE;
 		float current_reward_move_to_enemy = move_away_from_enemy ? -reward_move_to_enemy : reward_move_to_enemy;
 
 
@@ -263,59 +297,81 @@ namespace agents {
 			break; //only for the first move, as the leadsToDeadEnd can be deprecated if calculated with flames, bombs, woods. Yields better results.
 		}
 
-#ifdef DEBUGMODE_ON
-		stepRes.point = point;
-#else
+		if constexpr (Policy::DebugCapture)
+			leafReasons = reasons;
 		stepRes = point;
-#endif
 		return stepRes;
 	}
 
-	StepResult GottingenAgent::runAlreadyPlantedBombs(State *state) {
-		//#define USE_NEW_ONECALL_EXPLOSION //Bit slower! 'TickAndMoveBombs10' can be deleted!!
-#ifdef USE_NEW_ONECALL_EXPLOSION
-		util::TickAndMoveBombs10(*state);
-#else
-		for (int i = 0; i < BOMB_LIFETIME; i++) {
-			//Exit if match decided, maybe we would die later from an other bomb, so that disturbs pointing and decision making
-			if (state->aliveAgents < 2 || (state->aliveAgents == 2 && (state->agents[0].dead == state->agents[2].dead)))
-				break;
-
-			util::TickAndMoveBombs(*state);
-			state->relTimeStep++;
+	template <typename Policy>
+	StepResult SearchAgent<Policy>::runAlreadyPlantedBombs(State *state) {
+		trace::Span span("rollout", -1, 2);
+		if constexpr (Policy::OneCallExplosion) {
+			util::TickAndMoveBombs10(*state);
+			threadStats->rolloutTicks += 10;
+		}
+		else {
+			for (int i = 0; i < BOMB_LIFETIME; i++) {
+				//Exit if match decided, maybe we would die later from an other bomb, so that disturbs pointing and decision making
+				if (state->aliveAgents < 2 || (state->aliveAgents == 2 && (state->agents[0].dead == state->agents[2].dead)))
+					break;
+
+				util::TickAndMoveBombs(*state);
+				state->relTimeStep++;
+				threadStats->rolloutTicks++;
+			}
 		}
-#endif
 		return scoreState(state);
 	}
 
-	//#define RANDOM_TIEBREAK //With nobomb-random-tiebreak: 10% less simsteps, 3% less wins :( , 5-10% less ties against simple. Turned off by default. See log_test_02_tie.txt
-	//#define SCENE_HASH_MEMORY //8-10x less simsteps, but 40% less wins :((
-	StepResult GottingenAgent::runOneStep(const bboard::State *state, const int depth) {
+	template <typename Policy>
+	StepResult SearchAgent<Policy>::runOneStep(const bboard::State *state, const int depth) {
         StepResult stepRes;
         bboard::Move moves_in_one_step[4];
         const AgentInfo &a = state->agents[ourId];
         int choosenMove = 100;
-#ifdef DEBUGMODE_ON
-  		stepRes.point = -100;
-#else
 		stepRes = -100;
-#endif
 
-#ifdef RANDOM_TIEBREAK
-		FixedQueue<int, 6> bestmoves;
-#endif
-        StepResult stepRess[6];
+        // written by the root threads, one cache line each
+        CacheLinePadded<StepResult> paddedRess[6];
+		// the root moves are searched in parallel, their lines are collected in rootPV
+		float bestPoint = -10000.0f;
+		if constexpr (Policy::DebugCapture)
+			if (depth > 0)
+				pvTable.Leaf(4 * depth);
+
+		// Root moves without an escape from the bombs already on the board are not simulated (unless all moves
+		// are doomed). Only at the root: the oracle copies the state twice and simulates the flames.
+		bool safeMoves[6];
+		int safeMoveCount = 0;
+		if constexpr (Policy::EscapeOracle)
+			if (depth == 0)
+				safeMoveCount = SafeMoves(*state, ourId, safeMoves);
 #pragma omp set_dynamic(0)
-#pragma omp parallel for private(moves_in_one_step) shared(stepRes,stepRess) num_threads(depth < 1? 6 : 1)
+#pragma omp parallel for private(moves_in_one_step) shared(stepRes,paddedRess) num_threads(depth < 1? rootThreads : 1)
 		//int moves[]{1,2,3,4,0,5};
 		//for(int move : moves)
-		for (int move = 0; move < 6; move++)
+		for (int slot = 0; slot < 6; slot++)
 		{
-#ifdef DEBUGMODE_ON
-            stepRess[move].point = -10000.0f;
+            const int move = depth == 0 ? rootOrder[slot] : slot;
+            trace::Span span(depth == 0 ? "root move" : nullptr, move);
+            paddedRess[move].value = -10000.0f;
+#ifdef _OPENMP
+            const int rootThread = omp_get_thread_num();
 #else
-            stepRess[move] = -10000.0f;
+            const int rootThread = 0;
 #endif
+            if (depth == 0) {
+                threadStats = &perThreadStats[rootThread].value;
+                trace::SetAgent(ourId);
+                treeBuffer = dumpTree ? &treeBuffers[rootThread].value : nullptr;
+                rootMoveThread[move] = rootThread;
+            }
+            // the subtree was searched completely if no step of it got cancelled
+            const int64_t cancelledBefore = threadStats->cutoffs[SearchStats::CANCELLED];
+            const auto moveStart = depth == 0 ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point();
+            bboard::perf::ScopedSample hwSample(depth == 0 && rootThread > 0 && bboard::perf::Enabled() ?
+                &perThreadHw[rootThread].value : nullptr);
 
 			Position myDesiredPos = bboard::util::DesiredPosition(a.x, a.y, (bboard::Move) move);
 			// if we don't have bomb
@@ -327,6 +383,11 @@ namespace agents {
 			// if move is impossible
 			if (move > 0 && move < 5 && !_CheckPos2(state, myDesiredPos, ourId))
 				continue;
+			// if we would surely burn after this move
+			if (safeMoveCount > 0 && !safeMoves[move]) {
+				threadStats->prunedUnsafe++;
+				continue;
+			}
 			//no two opposite steps please - only after bomb if we can kick or powerup. Slower and worse.
 			//if ((state->agents[ourId].collectedPowerupPoints == 0 || depth < 2 || !state->agents[ourId].canKick || moves_in_chain[4*(depth - 2)+0] < 5) && depth > 0 &&  util::AreOppositeMoves(moves_in_chain[4*(depth - 1)], move))
 			//    continue;
@@ -384,8 +445,10 @@ namespace agents {
 						//if ((state->agents[enemy1Id].collectedPowerupPoints == 0 || depth < 2 || !state->agents[enemy1Id].canKick || moves_in_chain[4*(depth - 2)+2] < 5) && depth > 0 &&  util::AreOppositeMoves(moves_in_chain[4*(depth - 1)+2], moveE1))
 						//    continue;
 						//No long simulations if no step-bomb-step cycle
-						if (depth > 1 && moves_in_chain[4 * (depth - 2) + 2] != 5 && moves_in_chain[4 * (depth - 1) + 2] != 5 && moveE1 != 5)
+						if (depth > 1 && moves_in_chain[4 * (depth - 2) + 2] != 5 && moves_in_chain[4 * (depth - 1) + 2] != 5 && moveE1 != 5) {
+							threadStats->prunedNoBombCycle++;
 							continue;
+						}
 					}
 					else {
 						//We'll have same results with IDLE, IDLE
@@ -416,8 +479,10 @@ namespace agents {
 							//if ((state->agents[enemy2Id].collectedPowerupPoints == 0 || depth < 2 || !state->agents[enemy2Id].canKick || moves_in_chain[4*(depth - 2)+3] < 5) && depth > 0 &&  util::AreOppositeMoves(moves_in_chain[4*(depth - 1)+3], moveE2))
 							//    continue;
 							//No long simulations if no step-bomb-step cycle
-							if (depth > 1 && moves_in_chain[4 * (depth - 2) + 3] != 5 && moves_in_chain[4 * (depth - 1) + 3] != 5 && moveE2 != 5)
+							if (depth > 1 && moves_in_chain[4 * (depth - 2) + 3] != 5 && moves_in_chain[4 * (depth - 1) + 3] != 5 && moveE2 != 5) {
+								threadStats->prunedNoBombCycle++;
 								continue;
+							}
 						}
 						else {
 							//We'll have same results with IDLE, IDLE
@@ -429,18 +494,25 @@ namespace agents {
 						moves_in_one_step[enemy2Id] = (bboard::Move) moveE2;
 						moves_in_chain.AddElem(moveE2);
 
+						// the result of a cancelled search is dropped, just get out
+						if (Cancelled()) {
+							threadStats->cutoffs[SearchStats::CANCELLED]++;
+							moves_in_chain.count--;
+							continue;
+						}
+
 						bboard::State newstate(*state);
 						newstate.relTimeStep++;
 
 						if (!bboard::Step(&newstate, moves_in_one_step))
 						{
+							threadStats->cutoffs[SearchStats::STEP_FAILED]++;
 							moves_in_chain.count--;
 							continue;
 						}
-#pragma omp atomic
-						simulatedSteps++;
+						threadStats->nodes[depth]++;
 
-#ifdef SCENE_HASH_MEMORY
+						if constexpr (Policy::SceneHashMemory) {
 						uint128_t hash = ((((((((((((uint128_t)(newstate.agents[ourId].x * 11 + newstate.agents[ourId].y) * 121 +
 							(newstate.agents[enemy1Id].dead || newstate.agents[enemy1Id].x < 0 ? 0 : newstate.agents[enemy1Id].x * 11 + newstate.agents[enemy1Id].y)) * 121 +
 							(newstate.agents[enemy2Id].dead || newstate.agents[enemy2Id].x < 0 ? 0 : newstate.agents[enemy2Id].x * 11 + newstate.agents[enemy2Id].y)) * 121 +
@@ -455,14 +527,15 @@ namespace agents {
 							newstate.agents[ourId].bombStrength) * 10 +
 							newstate.agents[0].dead * 8 + newstate.agents[1].dead * 4 + newstate.agents[2].dead * 2 + newstate.agents[3].dead;
 
-						if (visitedSteps.count(hash) > 0) {
+						bool visited;
+#pragma omp critical(visitedSteps)
+						visited = !visitedSteps.insert(hash).second;
+						if (visited) {
+							threadStats->cutoffs[SearchStats::SCENE_VISITED]++;
 							moves_in_chain.count--;
 							continue;
 						}
-						else {
-							visitedSteps.insert(hash);
 						}
-#endif
 
 						Position myNewPos;
 						myNewPos.x = newstate.agents[newstate.ourId].x;
@@ -470,32 +543,50 @@ namespace agents {
 						positions_in_chain[depth] = myNewPos;
 						positions_in_chain.count++;
 
+						const int64_t subtreeNodesBefore = treeBuffer ? threadStats->TotalNodes() : 0;
+						const int64_t subtreeTicksBefore = threadStats->rolloutTicks;
 						StepResult futureSteps;
-						if (depth + 1 < myMaxDepth)
+						bool goDeeper = depth + 1 < myMaxDepth;
+						if constexpr (Policy::TimeLimit)
 						{
-#ifdef TIME_LIMIT_ON
-							size_t millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
-							if (millis > 147)
-								std::cout << "OVERTIME " << millis << std::endl;
-							if ((millis < 130) || (depth < 3 && millis < 140) || (depth < 2 && millis < 145))
-								futureSteps = runOneStep(&newstate, depth + 1);
-							else
-								futureSteps = runAlreadyPlantedBombs(&newstate);
-#else
-							futureSteps = runOneStep(&newstate, depth + 1);
-#endif
+							if (goDeeper && timeLimit)
+							{
+								const int level = deadline.Level();
+								goDeeper = (level == DeadlineTimer::NORMAL) || (depth < 3 && level <= DeadlineTimer::WRAP_UP)
+									|| (depth < 2 && level <= DeadlineTimer::FINISH);
+							}
 						}
+						if (goDeeper)
+							futureSteps = runOneStep(&newstate, depth + 1);
 						else
+						{
+							threadStats->leaves++;
+							threadStats->cutoffs[depth + 1 < myMaxDepth ? SearchStats::TIME_LIMIT : SearchStats::DEPTH_LIMIT]++;
 							futureSteps = runAlreadyPlantedBombs(&newstate);
+							if constexpr (Policy::DebugCapture)
+								pvTable.Leaf(4 * depth + 4, leafReasons);
+						}
+						if (treeBuffer) {
+							tree::Node node = {};
+							node.value = futureSteps;
+							node.subtreeNodes = (int32_t)(threadStats->TotalNodes() - subtreeNodesBefore + 1);
+							node.rolloutTicks = (int32_t)(threadStats->rolloutTicks - subtreeTicksBefore);
+							node.depth = (uint8_t)depth;
+							node.flags = goDeeper ? 0 : (tree::LEAF | (depth + 1 < myMaxDepth ? tree::TIME_CUTOFF : 0));
+							node.moves[0] = (uint8_t)moves_in_one_step[ourId];
+							node.moves[1] = (uint8_t)moves_in_one_step[teammateId];
+							node.moves[2] = (uint8_t)moves_in_one_step[enemy1Id];
+							node.moves[3] = (uint8_t)moves_in_one_step[enemy2Id];
+							treeBuffer->push_back(node);
+						}
 
 						Eavg += (float)futureSteps;
 						Eavg_count++;
 
 						if ((float)futureSteps > -100 && (float)futureSteps < minPointE2) {
 							minPointE2 = (float)futureSteps;
-#ifdef DEBUGMODE_STEPS
-							futureSteps.steps.AddElem(moveE2);
-#endif
+							if constexpr (Policy::DebugCapture)
+								pvTable.Update(4 * depth + 3, moveE2);
 							futureStepsE2 = futureSteps;
 						}
 
@@ -504,28 +595,22 @@ namespace agents {
 					}
 					if (minPointE2 > -100 && minPointE2 < minPointE1) {
 						minPointE1 = minPointE2;
-#ifdef DEBUGMODE_STEPS
-						futureStepsE2.steps.AddElem(moveE1);
-#endif
+						if constexpr (Policy::DebugCapture)
+							pvTable.Update(4 * depth + 2, moveE1);
 						futureStepsE1 = futureStepsE2;
 					}
 					moves_in_chain.count--;
 				}
 				if (minPointE1 < 100 && minPointE1 > maxTeammate) {
 					maxTeammate = minPointE1;
-#ifdef DEBUGMODE_STEPS
-					futureStepsE1.steps.AddElem(moveT);
-#endif
+					if constexpr (Policy::DebugCapture)
+						pvTable.Update(4 * depth + 1, moveT);
 					futureStepsT = futureStepsE1;
 				}
 
 
 				Eavg = Eavg_count ? Eavg / (float)Eavg_count : Eavg;
-#ifdef DEBUGMODE_STEPS
-				futureStepsT.point += Eavg * weight_of_average_Epoint;
-#else
 				futureStepsT += Eavg * weight_of_average_Epoint;
-#endif
 				maxTeammate += Eavg * weight_of_average_Epoint;
 
 
@@ -538,66 +623,103 @@ namespace agents {
 					std::cout << "point for move " << move << ": " << maxTeammate << std::endl;
 #endif
 
-#ifdef RANDOM_TIEBREAK
-				if (maxTeammate == maxPoint && move != 5) { bestmoves[bestmoves.count] = move; bestmoves.count++; }
-				if (maxTeammate > maxPoint) { maxPoint = maxTeammate; bestmoves.count = 1; bestmoves[0] = move; }
-#else
-//Save results
-				{
-
-#ifdef DEBUGMODE_STEPS
-						futureStepsT.steps.AddElem(move);
-#endif
-						stepRess[move] = futureStepsT;
+				//Save results
+				paddedRess[move].value = futureStepsT;
+				if constexpr (Policy::DebugCapture) {
+					if (depth == 0) {
+						rootPV[move][0] = move;
+						for (int i = 1; i < pvTable.length[1]; i++)
+							rootPV[move][i] = pvTable.moves[1][i];
+						rootPVLength[move] = pvTable.length[1];
+						rootReasons[move] = pvTable.reasons[1];
+					}
+					else if ((float)futureStepsT > bestPoint) {
+						bestPoint = (float)futureStepsT;
+						pvTable.Update(4 * depth, move);
+					}
 				}
-#endif
 			}
 			moves_in_chain.count--;
-		}
-
-#ifdef RANDOM_TIEBREAK
-May not work now
-		if (bestmoves.count > 0) {
-			if (maxPoint > best_points_in_chain[depth])
-			{
-				bool foundIdle = false;
-				for (int i = 0; i < bestmoves.count; i++)
-					if (bestmoves[i] == 0) {
-						best_moves_in_chain[depth] = 0;
-						foundIdle = true;
-					}
-				if (!foundIdle)
-					best_moves_in_chain[depth] = bestmoves[(state->timeStep / 4) % bestmoves.count];
-				best_points_in_chain[depth] = maxPoint;
+			if (depth == 0) {
+				rootMoveMillis[move] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - moveStart).count();
+				threadStats->rootSubtreeMillis += rootMoveMillis[move];
+				// a lost move completes too, it can't keep the quick move's place
+				if (threadStats->cutoffs[SearchStats::CANCELLED] == cancelledBefore)
+					PublishRootMove(move, (float)paddedRess[move].value);
 			}
 		}
-		else
-			best_moves_in_chain[depth] = 0;
-#else
+
+        StepResult stepRess[6];
+        for(int i=0; i<6; i++)
+            stepRess[i] = paddedRess[i].value;
+
         int bestIndex = 0;
         for(int i=1; i<6; i++)
         {
-  #ifdef DEBUGMODE_ON
-            if((float)stepRess[i] > stepRess[bestIndex].point)
-  #else
             if((float)stepRess[i] > stepRess[bestIndex])
-  #endif
                 bestIndex = i;
         }
 
-  #ifndef DEBUGMODE_STEPS
+        // IDLE if it's one of the best moves, otherwise a random one of the best moves except BOMB.
+        // (The PV keeps the first of the best moves at depth > 0)
+        if constexpr (Policy::RandomTieBreak)
+        {
+            FixedQueue<int, 6> bestmoves;
+            for(int i=0; i<5 && stepRess[bestIndex] > -10000.0f; i++)
+                if(stepRess[i] == stepRess[bestIndex])
+                    bestmoves.AddElem(i);
+            if(bestmoves.count > 0 && bestmoves[0] != 0)
+                bestIndex = bestmoves[(state->timeStep / 4) % bestmoves.count];
+        }
+
         if(depth == 0)
+        {
             depth_0_Move = bestIndex;
-  #endif
-#endif
+            for(int i=0; i<6; i++)
+                rootPoints[i] = (float)stepRess[i];
+        }
 
 		return stepRess[bestIndex];
 	}
 
-	void GottingenAgent::createDeadEndMap(const State *state) {
+	template <typename Policy>
+	void SearchAgent<Policy>::PublishRootMove(int move, float points) {
+		// the lowest of equally good moves, like the choice at the end of the search (but the quick move keeps its place)
+#pragma omp critical(completedRootMove)
+		{
+			rootCompleted[move] = true;
+			rootCompletedPoints[move] = points;
+			// the other threads finish smaller subtrees first, their moves wait for the quick move's subtree
+			if (quickMove >= 0 && completedRootMove < 0 && rootCompleted[quickMove]) {
+				completedRootMove = quickMove;
+				completedRootPoints = rootCompletedPoints[quickMove];
+			}
+			if (quickMove < 0 || completedRootMove >= 0) {
+				// a lost move never becomes the answer by itself
+				for (int m = 0; m < 6; m++) {
+					if (!rootCompleted[m] || rootCompletedPoints[m] <= -10000.0f)
+						continue;
+					const float p = rootCompletedPoints[m];
+					if (completedRootMove < 0 || p > completedRootPoints ||
+						(p == completedRootPoints && m < completedRootMove && quickMove < 0)) {
+						completedRootMove = m;
+						completedRootPoints = p;
+					}
+				}
+				if (completedRootMove >= 0)
+					bestMoveSoFar = completedRootMove;
+			}
+		}
+	}
+
+	template <typename Policy>
+	void SearchAgent<Policy>::createDeadEndMap(const State *state) {
+		trace::Span span("createDeadEndMap");
 		short walkable_neighbours[BOARD_SIZE * BOARD_SIZE];
 		memset(walkable_neighbours, 0, BOARD_SIZE * BOARD_SIZE * sizeof(short));
-		std::list<Position> deadEnds;
+		// no heap: act() doesn't allocate (unit_test/bboard/allocation_test.cpp)
+		Position deadEnds[BOARD_SIZE * BOARD_SIZE];
+		int deadEndCount = 0;
 		for (int x = 0; x < BOARD_SIZE; x++) {
 			for (int y = 0; y < BOARD_SIZE; y++) {
 				if (_CheckPos2(state, x, y)) {
@@ -605,10 +727,9 @@ May not work now
 						(int)_CheckPos2(state, x - 1, y) + (int)_CheckPos2(state, x, y - 1) +
 						(int)_CheckPos2(state, x + 1, y) + (int)_CheckPos2(state, x, y + 1);
 					if (walkable_neighbours[x + BOARD_SIZE * y] < 2) {
-						Position p;
-						p.x = x;
-						p.y = y;
-						deadEnds.push_back(p);
+						deadEnds[deadEndCount].x = x;
+						deadEnds[deadEndCount].y = y;
+						deadEndCount++;
 					}
 				}
 			}
@@ -617,25 +738,41 @@ May not work now
 
 		memset(leadsToDeadEnd, 0, BOARD_SIZE * BOARD_SIZE * sizeof(bool));
 
-		std::function<void(int, int)> recurseFillWaysToDeadEnds = [&](int x, int y) {
-			leadsToDeadEnd[x + BOARD_SIZE * y] = true;
-
-			if (x > 0 && walkable_neighbours[x - 1 + BOARD_SIZE * y] < 3 && !leadsToDeadEnd[x - 1 + BOARD_SIZE * y] && walkable_neighbours[x - 1 + BOARD_SIZE * y] > 0)
-				recurseFillWaysToDeadEnds(x - 1, y);
-			if (x < BOARD_SIZE - 1 && walkable_neighbours[x + 1 + BOARD_SIZE * y] < 3 && !leadsToDeadEnd[x + 1 + BOARD_SIZE * y] && walkable_neighbours[x + 1 + BOARD_SIZE * y] > 0)
-				recurseFillWaysToDeadEnds(x + 1, y);
-			if (y > 0 && walkable_neighbours[x + BOARD_SIZE * (y - 1)] < 3 && !leadsToDeadEnd[x + BOARD_SIZE * (y - 1)] && walkable_neighbours[x + BOARD_SIZE * (y - 1)] > 0)
-				recurseFillWaysToDeadEnds(x, y - 1);
-			if (y < BOARD_SIZE - 1 && walkable_neighbours[x + BOARD_SIZE * (y + 1)] < 3 && !leadsToDeadEnd[x + BOARD_SIZE * (y + 1)] && walkable_neighbours[x + BOARD_SIZE * (y + 1)] > 0)
-				recurseFillWaysToDeadEnds(x, y + 1);
+		// Marks the cells of the corridors to the dead ends, every cell is on the stack at most once
+		Position stack[BOARD_SIZE * BOARD_SIZE];
+		int stackCount = 0;
+		auto visit = [&](int x, int y) {
+			const int i = x + BOARD_SIZE * y;
+			if (walkable_neighbours[i] < 3 && walkable_neighbours[i] > 0 && !leadsToDeadEnd[i]) {
+				leadsToDeadEnd[i] = true;
+				stack[stackCount].x = x;
+				stack[stackCount].y = y;
+				stackCount++;
+			}
 		};
 
 		//#define DEBUG_LEADS_TO_DEAD_END
-		for (Position p : deadEnds) {
+		for (int d = 0; d < deadEndCount; d++) {
+			const Position p = deadEnds[d];
 #ifdef DEBUG_LEADS_TO_DEAD_END
 			std::cout << p.y << " " << p.x << std::endl;
 #endif
-			recurseFillWaysToDeadEnds(p.x, p.y);
+			if (leadsToDeadEnd[p.x + BOARD_SIZE * p.y])
+				continue;
+			leadsToDeadEnd[p.x + BOARD_SIZE * p.y] = true;
+			stack[0] = p;
+			stackCount = 1;
+			while (stackCount > 0) {
+				const Position c = stack[--stackCount];
+				if (c.x > 0)
+					visit(c.x - 1, c.y);
+				if (c.x < BOARD_SIZE - 1)
+					visit(c.x + 1, c.y);
+				if (c.y > 0)
+					visit(c.x, c.y - 1);
+				if (c.y < BOARD_SIZE - 1)
+					visit(c.x, c.y + 1);
+			}
 		}
 
 #ifdef DEBUG_LEADS_TO_DEAD_END
@@ -654,10 +791,33 @@ May not work now
 #endif
 	}
 
-	Move GottingenAgent::act(const State *state) {
+	template <typename Policy>
+	Move SearchAgent<Policy>::act(const State *state) {
+		// not a Span, it has to end before the turn is written
+		const int64_t actBegin = trace::level.load(std::memory_order_relaxed) > 0 ? trace::Now() : 0;
+		trace::SetAgent(state->ourId);
+		const bool measureHw = bboard::perf::Enabled();
+		// the quiet (calibration) agents don't dump their trees
+		const std::string treePath = verbose ? tree::DumpPath(state->ourId, state->timeStep) : "";
+		dumpTree = !treePath.empty();
+		for (auto& t : treeBuffers)
+			t.value.clear();
+		bboard::perf::Sample hwBegin;
+		if (measureHw) {
+			hwBegin = bboard::perf::ThreadCounters().Read();
+			for (auto& t : perThreadHw)
+				t.value = bboard::perf::Sample();
+		}
 		createDeadEndMap(state);
 		visitedSteps.clear();
 		simulatedSteps = 0;
+		stats = SearchStats();
+		for (auto& t : perThreadStats)
+			t.value = SearchStats();
+		for (int i = 0; i < 6; i++) {
+			rootMoveMillis[i] = 0.0;
+			rootMoveThread[i] = -1;
+		}
 		enemyIteration1 = 0;
 		enemyIteration2 = 0;
 		teammateIteration = 0;
@@ -711,6 +871,13 @@ May not work now
 		}
 		iteratedAgents = (teammateIteration > 0 ? 1 : 0) + (enemyIteration1 > 0 ? 1 : 0) + (enemyIteration2 > 0 ? 1 : 0);
 		myMaxDepth = 6 - iteratedAgents;
+		if constexpr (Policy::AdaptiveDepth) {
+			if (depthController.stepsPerMs <= 0.0f) {
+				depthController.stepsPerMs = calibratedStepsPerMs;
+				depthController.fill = calibratedFill;
+			}
+			depthController.Choose(myMaxDepth, teammateIteration, enemyIteration1, enemyIteration2);
+		}
 
 		rushing = state->timeStep < 75 && !state->agents[enemy1Id].dead && !state->agents[enemy2Id].dead && seenAgents < 2;
 
@@ -735,22 +902,31 @@ May not work now
 			previousPositions[agentId][previousPositions[agentId].count] = p;
 			previousPositions[agentId].count++;
 		}
-		if (sameAs6_12_turns_ago)
-			std::cout << "SAME AS BEFORE!!!!" << std::endl;
+		log::Record record = {};
+		record.timeStep = state->timeStep;
+		record.agentID = ourId;
+		if (sameAs6_12_turns_ago && verbose) {
+			record.type = log::SAME_AS_BEFORE;
+			log::Push(record);
+		}
 
 		const AgentInfo &a = state->agents[ourId];
 		if (state->timeStep > 1 && (expectedPosInNewTurn.x != a.x || expectedPosInNewTurn.y != a.y)) {
-			std::cout << "Couldn't move to " << expectedPosInNewTurn.y << ":" << expectedPosInNewTurn.x;
+			record.type = log::COULDNT_MOVE;
+			record.args[0] = expectedPosInNewTurn.y;
+			record.args[1] = expectedPosInNewTurn.x;
+			record.args[2] = 0;
 			if (std::abs(state->agents[teammateId].x - expectedPosInNewTurn.x) +
 				std::abs(state->agents[teammateId].y - expectedPosInNewTurn.y) == 1)
-				std::cout << " - Racing with teammate, probably";
+				record.args[2] |= log::RACING_TEAMMATE;
 			if (std::abs(state->agents[enemy1Id].x - expectedPosInNewTurn.x) +
 				std::abs(state->agents[enemy1Id].y - expectedPosInNewTurn.y) == 1)
-				std::cout << " - Racing with enemy1, probably";
+				record.args[2] |= log::RACING_ENEMY1;
 			if (std::abs(state->agents[enemy2Id].x - expectedPosInNewTurn.x) +
 				std::abs(state->agents[enemy2Id].y - expectedPosInNewTurn.y) == 1)
-				std::cout << " - Racing with enemy2, probably";
-			std::cout << std::endl;
+				record.args[2] |= log::RACING_ENEMY2;
+			if (verbose)
+				log::Push(record);
 			lastMoveWasBlocked = true;
 			lastBlockedMove = moveHistory[moveHistory.count - 1];
 		}
@@ -760,31 +936,119 @@ May not work now
 
 		goingAround = state->timeStep > 75 && (state->timeStep - lastSeenEnemy) > 2;
 
-		StepResult stepRes = runOneStep(state, 0);
+		// If only one move escapes from the bombs already on the board, there is nothing to search
+		Move forcedMove = Move::IDLE;
+		bool forced = false;
+		if constexpr (Policy::EscapeOracle)
+			forced = ForcedEscapeMove(*state, ourId, forcedMove);
+		StepResult stepRes;
+		float searchMillis = 0.0f;
+		principalVariation.count = 0;
+		principalReasons = 0;
+		bestMoveSoFar = (int)forcedMove;
+		completedRootMove = -1;
+		quickMove = -1;
+		for (int i = 0; i < 6; i++) {
+			rootOrder[i] = i;
+			rootCompleted[i] = false;
+		}
+		bool cancelled = false;
+		if (forced) {
+			stepRes = 0.0f;
+			depth_0_Move = (int)forcedMove;
+			principalVariation.AddElem(depth_0_Move);
+		}
+		else {
+			// The kill solver works on spare cores while the main search is running
+			if (useKillSolver)
+				killSolver.Start(*state, ourId, enemy1Id, enemy2Id);
+			if (timeLimit || cancelToken)
+				deadline.Start(cancelToken ? cancelDeadline : start_time + std::chrono::milliseconds(DeadlineTimer::defaultDeadlineMillis));
+			auto searchStart = std::chrono::high_resolution_clock::now();
+			StepResult quickRes = 0.0f;
+			int64_t quickCancelled = 0;
+			if (cancelToken) {
+				// its move is the answer until its own subtree of the full search is searched completely
+				const int fullDepth = myMaxDepth;
+				myMaxDepth = 1;
+				{
+					trace::Span quickSpan("quick search");
+					quickRes = runOneStep(state, 0);
+				}
+				myMaxDepth = fullDepth;
+				for (auto& t : perThreadStats)
+					quickCancelled += t.value.cutoffs[SearchStats::CANCELLED];
+				quickMove = completedRootMove;
+				bestMoveSoFar = quickMove >= 0 ? quickMove : (int)forcedMove;
+				completedRootMove = -1;
+				for (int i = 0; i < 6; i++)
+					rootCompleted[i] = false;
+				// the full search starts with it, a single thread searches it first
+				std::swap(rootOrder[0], rootOrder[bestMoveSoFar]);
+			}
+			{
+				trace::Span searchSpan("search", myMaxDepth);
+				stepRes = runOneStep(state, 0);
+			}
+			for (auto& t : perThreadStats)
+				stats.Add(t.value);
+			// cut short, not just over the deadline after the search finished
+			cancelled = stats.cutoffs[SearchStats::CANCELLED] > quickCancelled;
+			if (cancelled) {
+				depth_0_Move = bestMoveSoFar;
+				stepRes = completedRootMove >= 0 ? completedRootPoints : quickRes;
+			}
+			searchMillis = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - searchStart).count();
+			stats.searchMillis = searchMillis;
+			simulatedSteps = (int)stats.TotalNodes();
+			if (timeLimit || cancelToken)
+				deadline.Stop();
+			if (timeLimit) {
+				size_t millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
+				if (millis > 147 && verbose) {
+					bboard::metrics::Agents().overtimes.Add();
+					record.type = log::OVERTIME;
+					record.args[0] = (int)millis;
+					log::Push(record);
+				}
+			}
+			if constexpr (Policy::DebugCapture) {
+				// the line of a root move is known once its subtree is complete
+				if (cancelled && completedRootMove < 0)
+					principalVariation.AddElem(depth_0_Move);
+				else {
+					for (int i = 0; i < rootPVLength[depth_0_Move]; i++)
+						principalVariation.AddElem(rootPV[depth_0_Move][i]);
+					principalReasons = rootReasons[depth_0_Move];
+				}
+			}
+		}
 
-#ifdef DISPLAY_EXPECTATION
-		bboard::Move moves_in_one_step[4];
-#endif
-#ifdef DEBUGMODE_STEPS
-		if(stepRes.steps.count < 4)
-		    throw std::runtime_error("no steps");
-		int myMove = stepRes.steps[stepRes.steps.count - 1];
-  #ifdef DISPLAY_EXPECTATION
-		moves_in_one_step[ourId] = (bboard::Move)stepRes.steps[stepRes.steps.count - 1];
-		moves_in_one_step[teammateId] = (bboard::Move)stepRes.steps[stepRes.steps.count - 2];
-		moves_in_one_step[enemy1Id] = (bboard::Move)stepRes.steps[stepRes.steps.count - 3];
-		moves_in_one_step[enemy2Id] = (bboard::Move)stepRes.steps[stepRes.steps.count - 4];
-  #endif
-#else
 		int myMove = depth_0_Move;
+
+		Move killMove;
+		int killTarget = -1;
+		bool killing = false;
+		if (!forced && useKillSolver && killSolver.Finish(killMove, killTarget) && !cancelled &&
+			rootPoints[(int)killMove] > killSolver_min_root_point) {
+			killing = true;
+			if (myMove != (int)killMove) {
+				myMove = (int)killMove;
+				principalVariation.count = 0;
+				for (int i = 0; i < rootPVLength[myMove]; i++)
+					principalVariation.AddElem(rootPV[myMove][i]);
+				principalReasons = rootReasons[myMove];
+			}
+		}
+
+		bestMoveSoFar = myMove;
+
 #ifdef DISPLAY_EXPECTATION
+		bboard::Move moves_in_one_step[4];
 		moves_in_one_step[ourId] = (bboard::Move)myMove;
-		moves_in_one_step[teammateId] = (bboard::Move)0;
-		moves_in_one_step[enemy1Id] = (bboard::Move)0;
-		moves_in_one_step[enemy2Id] = (bboard::Move)0;
-#endif
-#endif
-#ifdef DISPLAY_EXPECTATION
+		moves_in_one_step[teammateId] = (bboard::Move)(principalVariation.count > 1 ? principalVariation[1] : 0);
+		moves_in_one_step[enemy1Id] = (bboard::Move)(principalVariation.count > 2 ? principalVariation[2] : 0);
+		moves_in_one_step[enemy2Id] = (bboard::Move)(principalVariation.count > 3 ? principalVariation[3] : 0);
 		State * newState = new State(*state);
 		bboard::Step(newState, moves_in_one_step);
 		std::cout << "Expected state" << std::endl;
@@ -797,23 +1061,28 @@ May not work now
 		moveHistory[moveHistory.count] = myMove;
 		moveHistory.count++;
 
-		std::cout << "turn#" << state->timeStep << " ourId:" << ourId << " point: " << (float)stepRes << " selected: ";
-		std::cout << myMove << " simulated steps: " << simulatedSteps;
-		std::cout << ", depth " << myMaxDepth << " " << teammateIteration << " " << enemyIteration1 << " "
-			<< enemyIteration2 << (rushing ? " rushing" : "") << (goingAround ? " goingAround" : "") << std::endl;
-#ifdef DEBUGMODE_STEPS
-		for (int i = 0; i < stepRes.steps.count; i++) {
-			std::cout << (int)stepRes.steps[stepRes.steps.count - 1 - i] << " ";
-			if (i % 4 == 3)
-				std::cout << " | ";
+		if (verbose) {
+			record.type = log::TURN;
+			record.flags = (rushing ? log::RUSHING : 0) | (goingAround ? log::GOING_AROUND : 0) | (forced ? log::FORCED : 0)
+				| (cancelled ? log::CANCELLED : 0) | (killing ? log::KILL : 0) | (Policy::DebugCapture ? log::HAS_PV : 0);
+			record.move = myMove;
+			record.value = (float)stepRes;
+			record.simulatedSteps = simulatedSteps;
+			record.depth = myMaxDepth;
+			record.iterations[0] = teammateIteration;
+			record.iterations[1] = enemyIteration1;
+			record.iterations[2] = enemyIteration2;
+			record.args[0] = killTarget;
+			record.args[1] = killSolver.provenDepth;
+			record.args[2] = killSolver.nodes;
+			record.reasons = principalReasons;
+			// the expected line of the deepest search fits, a longer one is cut to the record
+			static_assert(sizeof(record.pv) >= 4 * DepthController::maxDepth, "Record::pv is shorter than the PV of the deepest search");
+			record.pvLength = std::min(principalVariation.count, (int)sizeof(record.pv));
+			for (int i = 0; i < record.pvLength; i++)
+				record.pv[i] = (int8_t)principalVariation[i];
+			log::Push(record);
 		}
-#endif
-
-#ifdef DEBUGMODE_COMMENTS
-		std::cout << stepRes.comment << std::endl;
-#else
-		std::cout << std::endl;
-#endif
 
 		if(sameAs6_12_turns_ago && turns > 80 && seenEnemies > 0 && seenAgents == seenEnemies) {
             message[0] = FrankfurtMessageTypes::ComeAround7;
@@ -865,13 +1134,137 @@ May not work now
         }
         message[1] = std::min(7, message[1]);
 
+		if constexpr (Policy::AdaptiveDepth)
+			depthController.Record(simulatedSteps, searchMillis,
+				std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start_time).count(),
+				!forced && !cancelled && stats.cutoffs[SearchStats::TIME_LIMIT] == 0,
+				myMaxDepth, teammateIteration, enemyIteration1, enemyIteration2);
+
+		// the quiet (calibration) agents are not counted
+		if (verbose) {
+			bboard::metrics::AgentMetrics& metrics = bboard::metrics::Agents();
+			metrics.turns.Add();
+			metrics.nodes.Add(simulatedSteps);
+			metrics.rollouts.Add(stats.leaves);
+			metrics.rolloutTicks.Add(stats.rolloutTicks);
+			if constexpr (Policy::SceneHashMemory) {
+				metrics.sceneLookups.Add(simulatedSteps);
+				metrics.sceneHits.Add(stats.cutoffs[SearchStats::SCENE_VISITED]);
+			}
+			metrics.turnSeconds.Observe(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count());
+			if (!forced) {
+				if (searchMillis > 0.0f)
+					metrics.nodesPerSecond.Observe(simulatedSteps * 1000.0 / searchMillis);
+				metrics.depth.Observe(myMaxDepth);
+			}
+		}
+
 		totalSimulatedSteps += simulatedSteps;
 		turns++;
 		expectedPosInNewTurn = bboard::util::DesiredPosition(a.x, a.y, (bboard::Move) myMove);
+		if (dumpTree && !forced) {
+			tree::Header header = {};
+			header.timeStep = state->timeStep;
+			header.agentId = ourId;
+			header.chosenMove = myMove;
+			header.maxDepth = myMaxDepth;
+			header.iterations[0] = teammateIteration;
+			header.iterations[1] = enemyIteration1;
+			header.iterations[2] = enemyIteration2;
+			header.averageWeight = weight_of_average_Epoint;
+			for (int i = 0; i < 6; i++)
+				header.rootPoints[i] = rootPoints[i];
+			std::vector<tree::Node> buffers[6];
+			for (int i = 0; i < 6; i++)
+				buffers[i].swap(treeBuffers[i].value);
+			tree::Write(treePath, header, buffers, 6);
+		}
+		if (measureHw) {
+			hwCounters = bboard::perf::ThreadCounters().Read() - hwBegin;
+			for (auto& t : perThreadHw)
+				hwCounters += t.value;
+			totalHwCounters += hwCounters;
+		}
+		if (trace::level.load(std::memory_order_relaxed) > 0) {
+			trace::Record("act", actBegin, trace::Now(), myMove);
+			trace::EndTurn(ourId, state->timeStep);
+		}
 		return (bboard::Move) myMove;
 	}
 
-	void GottingenAgent::PrintDetailedInfo() {
+	template <typename Policy>
+	Move SearchAgent<Policy>::act(const State *state, const std::atomic<bool> *cancel,
+		std::chrono::high_resolution_clock::time_point deadline) {
+		cancelToken = cancel;
+		cancelDeadline = deadline;
+		Move move = act(state);
+		cancelToken = nullptr;
+		return move;
+	}
+
+	template <typename Policy>
+	void SearchAgent<Policy>::PrintDetailedInfo() {
 	}
 
+	template <typename Policy>
+	void SearchAgent<Policy>::CalibrationPosition(int i, State& state) {
+		// the agents meet in the middle of the board, all of them are iterated
+		const Position positions[4] = { {3, 4}, {6, 4}, {6, 6}, {3, 6} };
+		state = State();
+		InitBoardItems(state, i + 1);
+		for (int a = 0; a < 4; a++) {
+			state.PutItem(positions[a].x, positions[a].y, Item::PASSAGE);
+			state.PutAgent(positions[a].x, positions[a].y, a);
+		}
+		state.ourId = 0;
+		state.teammateId = 2;
+		state.enemy1Id = 1;
+		state.enemy2Id = 3;
+	}
+
+	template <typename Policy>
+	void SearchAgent<Policy>::Calibrate() {
+		if (calibratedStepsPerMs > 0.0f)
+			return;
+
+		// the calibration turns are not traced
+		const int traceLevel = trace::level.exchange(0);
+		int steps = 0;
+		float millis = 0.0f;
+		float completeSteps = 0.0f, completeEstimate = 0.0f;
+		for (int i = 0; i < calibrationPositions; i++) {
+			State state;
+			CalibrationPosition(i, state);
+
+			SearchAgent<Policy> agent;
+			agent.id = 0;
+			agent.verbose = false;
+			agent.useKillSolver = false;
+			agent.start_time = std::chrono::high_resolution_clock::now();
+			agent.act(&state);
+			millis += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - agent.start_time).count();
+			steps += agent.simulatedSteps;
+			// the fixed depth of a turn, the controller is off until calibrated
+			if (agent.stats.cutoffs[SearchStats::TIME_LIMIT] == 0) {
+				completeSteps += agent.simulatedSteps;
+				completeEstimate += DepthController::Estimate(agent.myMaxDepth, agent.teammateIteration,
+					agent.enemyIteration1, agent.enemyIteration2);
+			}
+		}
+		trace::level = traceLevel;
+		calibratedStepsPerMs = steps / std::max(1.0f, millis);
+		if (completeEstimate > 0.0f)
+			calibratedFill = std::min(1.0f, completeSteps / completeEstimate);
+
+		log::Record record = {};
+		record.type = log::CALIBRATION;
+		record.agentID = -1;
+		record.value = calibratedStepsPerMs;
+		record.args[0] = (int)std::lround(calibratedFill * 1000.0f);
+		log::Push(record);
+	}
+
+	template struct SearchAgent<FrankfurtPolicy>;
+	template struct SearchAgent<GottingenPolicy>;
+
 }
@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "search_tree.hpp"
+
+namespace agents::tree
+{
+
+std::string DumpPath(int agentId, int timeStep)
+{
+    static const char* prefix = std::getenv("POMMERMAN_TREE_DUMP");
+    static const char* turn = std::getenv("POMMERMAN_TREE_DUMP_TURN");
+    if(!prefix || (turn && std::atoi(turn) != timeStep))
+        return "";
+    return std::string(prefix) + ".agent" + std::to_string(agentId) + ".turn" + std::to_string(timeStep) + ".tree";
+}
+
+/**
+ * @brief FillLegalMoves Sets the legal moves of the nodes of a post-order
+ * sequence from their children
+ */
+static void FillLegalMoves(std::vector<Node>& nodes)
+{
+    // moves seen at each depth since the last node of the depth above
+    uint8_t seen[256][4] = {};
+    for(Node& n : nodes)
+    {
+        for(int a = 0; a < 4; a++)
+        {
+            int count = 0;
+            for(int m = 0; m < 8; m++)
+                count += (seen[n.depth + 1][a] >> m) & 1;
+            n.legalMoves[a] = (uint8_t)count;
+            seen[n.depth + 1][a] = 0;
+            seen[n.depth][a] |= 1 << n.moves[a];
+        }
+    }
+}
+
+bool Write(const std::string& path, Header header, std::vector<Node>* buffers, int bufferCount)
+{
+    std::ofstream out(path, std::ios::binary);
+    if(!out)
+    {
+        std::cout << "Couldn't write the search tree " << path << std::endl;
+        return false;
+    }
+
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.nodeCount = 0;
+    for(int i = 0; i < bufferCount; i++)
+    {
+        FillLegalMoves(buffers[i]);
+        header.nodeCount += (int32_t)buffers[i].size();
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for(int i = 0; i < bufferCount; i++)
+    {
+        out.write(reinterpret_cast<const char*>(buffers[i].data()), buffers[i].size() * sizeof(Node));
+    }
+    return (bool)out;
+}
+
+bool Read(const std::string& path, Header& header, std::vector<Node>& nodes)
+{
+    std::ifstream in(path, std::ios::binary);
+    if(!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+            || header.nodeCount < 0)
+        return false;
+
+    nodes.resize(header.nodeCount);
+    return (bool)in.read(reinterpret_cast<char*>(nodes.data()), nodes.size() * sizeof(Node));
+}
+
+}
@@ -7,6 +7,7 @@
 #include "bboard.hpp"
 #include "colors.hpp"
 #include "agents.hpp"
+#include "trace.hpp"
 #include <map>
 #include <fstream>
 #include <sstream>
@@ -154,10 +155,12 @@ bool _CheckPos_any(State * state, int x, int y)
 
 void State::ExplodeBombAt(int i)
 {
-    if(BMB_ID_KNOWN(bombs[i]))
-        agents[BMB_ID(bombs[i])].bombCount--;
-    SpawnFlame(BMB_POS_X(bombs[i]), BMB_POS_Y(bombs[i]), BMB_STRENGTH(bombs[i]), BMB_ID(bombs[i]));
+    const Bomb b = bombs[i];
+    if(BMB_ID_KNOWN(b))
+        agents[BMB_ID(b)].bombCount--;
+    // the flames explode the chained bombs, which moves the bombs behind them
     bombs.RemoveAt(i);
+    SpawnFlame(BMB_POS_X(b), BMB_POS_Y(b), BMB_STRENGTH(b), BMB_ID(b));
 }
 void State::PlantBomb(int x, int y, int id, bool setItem)
 {
@@ -706,6 +709,8 @@ void init_agent_frankfurt(int id)
 }
 void init_agent_gottingen(int id)
 {
+    // the speed of the search is measured once, the agents choose their depth by it
+    agents::GottingenAgent::Calibrate();
     envs[id] = std::make_shared<bboard::Environment>();
     gottingenAgents[id] = std::make_shared<agents::GottingenAgent>();
     envs[id]->MakeGameFromPython(id);
@@ -718,6 +723,9 @@ float episode_end_frankfurt(int id)
         frankfurtAgents[id]->turns++;
     float avg_simsteps_per_turn = frankfurtAgents[id]->totalSimulatedSteps / (float)frankfurtAgents[id]->turns;
     std::cout << "Episode end for agent " << id << ". Turns: " << frankfurtAgents[id]->turns << " avg.sim.steps: " << avg_simsteps_per_turn << std::endl;
+    if(bboard::perf::Enabled())
+        bboard::perf::Report(std::cout, "act()", frankfurtAgents[id]->totalHwCounters, frankfurtAgents[id]->totalSimulatedSteps);
+    bboard::trace::EndEpisode(id);
     frankfurtAgents[id] = std::make_shared<agents::FrankfurtAgent>();
     envs[id] = std::make_shared<bboard::Environment>();
     envs[id]->MakeGameFromPython(id);
@@ -729,6 +737,9 @@ float episode_end_gottingen(int id)
         gottingenAgents[id]->turns++;
     float avg_simsteps_per_turn = gottingenAgents[id]->totalSimulatedSteps / (float)gottingenAgents[id]->turns;
     std::cout << "Episode end for agent " << id << ". Turns: " << gottingenAgents[id]->turns << " avg.sim.steps: " << avg_simsteps_per_turn << std::endl;
+    if(bboard::perf::Enabled())
+        bboard::perf::Report(std::cout, "act()", gottingenAgents[id]->totalHwCounters, gottingenAgents[id]->totalSimulatedSteps);
+    bboard::trace::EndEpisode(id);
     gottingenAgents[id] = std::make_shared<agents::GottingenAgent>();
     envs[id] = std::make_shared<bboard::Environment>();
     envs[id]->MakeGameFromPython(id);
@@ -742,6 +753,8 @@ int getStep_frankfurt(int id, bool agent0Alive, bool agent1Alive, bool agent2Ali
     std::cout << std::endl;
 #endif
 
+    // the conversion is a span of this agent's turn
+    bboard::trace::SetAgent(id);
     envs[id]->MakeGameFromPython_frankfurt(agent0Alive, agent1Alive, agent2Alive, agent3Alive, board, bomb_life, bomb_blast_strength, bomb_moving_direction, flame_life, posx, posy, blast_strength, can_kick, ammo, game_type, teammate_id, message1, message2);
 
     frankfurtAgents[id]->id = envs[id]->GetState().ourId;
@@ -759,6 +772,8 @@ int getStep_gottingen(int id, bool agent0Alive, bool agent1Alive, bool agent2Ali
     std::cout << std::endl;
 #endif
 
+    // the conversion is a span of this agent's turn
+    bboard::trace::SetAgent(id);
     envs[id]->MakeGameFromPython_gottingen(agent0Alive, agent1Alive, agent2Alive, agent3Alive, board, bomb_life, bomb_blast_strength, bomb_moving_direction, flame_life, posx, posy, blast_strength, can_kick, ammo, game_type, teammate_id, message1, message2);
 
     gottingenAgents[id]->id = envs[id]->GetState().ourId;
@@ -770,6 +785,31 @@ int getStep_gottingen(int id, bool agent0Alive, bool agent1Alive, bool agent2Ali
     return (int)gottingenAgents[id]->act(&envs[id]->GetState());
 }
 
+// set by c_cancel_gottingen, from any thread
+std::array<std::atomic<bool>, 4> gottingenCancel;
+
+int getStep_gottingen_deadline(int id, int deadline_millis, bool agent0Alive, bool agent1Alive, bool agent2Alive, bool agent3Alive, uint8_t * board, double * bomb_life, double * bomb_blast_strength, double * bomb_moving_direction, double * flame_life, int posx, int posy, int blast_strength, bool can_kick, int ammo, int game_type, int teammate_id, int message1, int message2)
+{
+    gottingenAgents[id]->start_time = std::chrono::high_resolution_clock::now();
+    gottingenCancel[id] = false;
+#ifdef VERBOSE_STATE
+    std::cout << std::endl;
+#endif
+
+    // the conversion is a span of this agent's turn
+    bboard::trace::SetAgent(id);
+    envs[id]->MakeGameFromPython_gottingen(agent0Alive, agent1Alive, agent2Alive, agent3Alive, board, bomb_life, bomb_blast_strength, bomb_moving_direction, flame_life, posx, posy, blast_strength, can_kick, ammo, game_type, teammate_id, message1, message2);
+
+    gottingenAgents[id]->id = envs[id]->GetState().ourId;
+#ifdef VERBOSE_STATE
+    PrintState(&envs[id]->GetState());
+#endif
+
+    // Ask the agent where to go, it answers by the deadline at the latest
+    auto deadline = gottingenAgents[id]->start_time + std::chrono::milliseconds(deadline_millis);
+    return (int)gottingenAgents[id]->act(&envs[id]->GetState(), &gottingenCancel[id], deadline);
+}
+
 int getMessage_frankfurt(int id, int messagePart)
 {
     return frankfurtAgents[id]->message[messagePart];
@@ -780,6 +820,7 @@ int getMessage_gottingen(int id, int messagePart)
     return gottingenAgents[id]->message[messagePart];
 }
 
+// the first decisions of these tests are also in the scenario corpus (benchmark/scenarios)
 void tests()
 {
     int tests_run = 0;
@@ -1083,4 +1124,34 @@ EXPORTIT int c_getMessage_gottingen(int id, int messagePart)
     return getMessage_gottingen(id, messagePart);
 }
 
+EXPORTIT int c_getStep_gottingen_deadline(int id, int deadline_millis, bool agent0Alive, bool agent1Alive, bool agent2Alive, bool agent3Alive, uint8_t * board, double * bomb_life, double * bomb_blast_strength, double * bomb_moving_direction, double * flame_life, int posx, int posy, int blast_strength, bool can_kick, int ammo, int game_type, int teammate_id, int message1, int message2)
+{
+    return getStep_gottingen_deadline(id, deadline_millis, agent0Alive, agent1Alive, agent2Alive, agent3Alive, board, bomb_life, bomb_blast_strength, bomb_moving_direction, flame_life, posx, posy, blast_strength, can_kick, ammo, game_type, teammate_id, message1, message2);
+}
+// these two can be called from another thread while c_getStep_gottingen_deadline is running
+EXPORTIT void c_cancel_gottingen(int id)
+{
+    gottingenCancel[id] = true;
+}
+EXPORTIT int c_getBestMoveSoFar_gottingen(int id)
+{
+    return gottingenAgents[id]->bestMoveSoFar;
+}
+
+// the next getStep is turn timeStep + 1, for replaying an observation of a later turn
+EXPORTIT void c_setTimeStep(int id, int timeStep)
+{
+    envs[id]->GetState().timeStep = timeStep;
+}
+
+// statistics of the last step, see agents::SearchStats for the layout
+EXPORTIT void c_getSearchStats_frankfurt(int id, agents::SearchStats * stats)
+{
+    *stats = frankfurtAgents[id]->stats;
+}
+EXPORTIT void c_getSearchStats_gottingen(int id, agents::SearchStats * stats)
+{
+    *stats = gottingenAgents[id]->stats;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "decision_log.hpp"
+#include "agents.hpp"
+
+namespace bboard::log
+{
+
+void Format(const Record& r, std::ostream& out)
+{
+    switch(r.type)
+    {
+        case TURN:
+            out << "turn#" << r.timeStep << " ourId:" << r.agentID << " point: " << r.value << " selected: ";
+            out << r.move << " simulated steps: " << r.simulatedSteps;
+            out << ", depth " << r.depth << " " << r.iterations[0] << " " << r.iterations[1] << " "
+                << r.iterations[2] << (r.flags & RUSHING ? " rushing" : "") << (r.flags & GOING_AROUND ? " goingAround" : "")
+                << (r.flags & FORCED ? " forced" : "") << (r.flags & CANCELLED ? " cancelled" : "");
+            if(r.flags & KILL)
+                out << " kill " << r.args[0] << " in " << r.args[1] << " (" << r.args[2] << " nodes)";
+            out << "\n";
+            if(r.flags & HAS_PV)
+            {
+                for(int i = 0; i < r.pvLength; i++)
+                {
+                    out << (int)r.pv[i] << " ";
+                    if(i % 4 == 3)
+                        out << " | ";
+                }
+                out << agents::ReasonsToString(r.reasons) << "\n";
+            }
+            else
+                out << "\n";
+            break;
+        case SAME_AS_BEFORE:
+            out << "SAME AS BEFORE!!!!\n";
+            break;
+        case COULDNT_MOVE:
+            out << "Couldn't move to " << r.args[0] << ":" << r.args[1];
+            if(r.args[2] & RACING_TEAMMATE)
+                out << " - Racing with teammate, probably";
+            if(r.args[2] & RACING_ENEMY1)
+                out << " - Racing with enemy1, probably";
+            if(r.args[2] & RACING_ENEMY2)
+                out << " - Racing with enemy2, probably";
+            out << "\n";
+            break;
+        case OVERTIME:
+            out << "OVERTIME " << r.args[0] << "\n";
+            break;
+        case LEARNED:
+        {
+            static const char* items[] = {"maxBombCount", "teammate canKick", "enemy1 canKick", "enemy2 canKick",
+                                          "x", "y", "BombStrength", "ComeAround"};
+            out << "Learned from message: " << items[r.args[0]] << ": " << r.args[1];
+            if(r.args[0] != COME_AROUND)
+                out << " (prev. assumed " << r.args[2] << ")";
+            out << "\n";
+            break;
+        }
+        case CALIBRATION:
+            out << "Calibration: " << r.value << " simulated steps/ms, " << r.args[0] / 1000.0f
+                << " of the estimated tree\n";
+            break;
+        default:
+            out << "Unknown log record " << r.type << "\n";
+    }
+}
+
+DecisionLog& DecisionLog::Get()
+{
+    static DecisionLog decisionLog;
+    return decisionLog;
+}
+
+DecisionLog::DecisionLog()
+{
+    for(int i = 0; i < CAPACITY; i++)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker = std::thread(&DecisionLog::Run, this);
+}
+
+DecisionLog::~DecisionLog()
+{
+    quit = true;
+    worker.join();
+}
+
+bool DecisionLog::Push(const Record& r)
+{
+    uint64_t pos = head.load(std::memory_order_relaxed);
+    Slot* slot;
+    while(true)
+    {
+        slot = &slots[pos % CAPACITY];
+        const int64_t diff = (int64_t)slot->sequence.load(std::memory_order_acquire) - (int64_t)pos;
+        if(diff == 0)
+        {
+            if(head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if(diff < 0)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->record = r;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool DecisionLog::Pop(Record& r)
+{
+    // only the worker pops
+    const uint64_t pos = tail.load(std::memory_order_relaxed);
+    Slot& slot = slots[pos % CAPACITY];
+    if(slot.sequence.load(std::memory_order_acquire) != pos + 1)
+        return false;
+    r = slot.record;
+    slot.sequence.store(pos + CAPACITY, std::memory_order_release);
+    tail.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void DecisionLog::Flush()
+{
+    // dropped records never get a slot, they don't count here
+    const uint64_t pushed = head.load(std::memory_order_acquire);
+    while(written.load(std::memory_order_acquire) < pushed)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+int64_t DecisionLog::Dropped() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void DecisionLog::Run()
+{
+    FILE* file = nullptr;
+    if(const char* path = std::getenv("POMMERMAN_DECISION_LOG"))
+    {
+        file = std::fopen(path, "wb");
+        if(file)
+            std::fwrite(FILE_MAGIC, 1, sizeof(FILE_MAGIC), file);
+        else
+            std::cout << "Couldn't open the decision log " << path << ", printing it" << std::endl;
+    }
+
+    Record r;
+    std::ostringstream text;
+    while(true)
+    {
+        // quit is read first, so that nothing pushed before it is lost
+        const bool last = quit.load();
+        int count = 0;
+        while(Pop(r))
+        {
+            if(file)
+                std::fwrite(&r, sizeof(Record), 1, file);
+            else
+                Format(r, text);
+            count++;
+        }
+        if(count > 0)
+        {
+            if(file)
+            {
+                std::fflush(file);
+            }
+            else
+            {
+                std::cout << text.str() << std::flush;
+                text.str("");
+            }
+            written.fetch_add(count, std::memory_order_release);
+        }
+        if(last)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    if(file)
+        std::fclose(file);
+}
+
+}
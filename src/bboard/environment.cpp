@@ -5,10 +5,27 @@
 
 #include "bboard.hpp"
 #include "step_utility.hpp"
+#include "decision_log.hpp"
+#include "trace.hpp"
 
 namespace bboard
 {
 
+/**
+ * @brief LogLearned Logs a correction of the state from the teammate's message
+ */
+static void LogLearned(const State* state, log::LearnedItem item, int value, int previous)
+{
+    log::Record record = {};
+    record.type = log::LEARNED;
+    record.timeStep = state->timeStep;
+    record.agentID = state->ourId;
+    record.args[0] = item;
+    record.args[1] = value;
+    record.args[2] = previous;
+    log::Push(record);
+}
+
 void Pause(bool timeBased)
 {
     if(!timeBased)
@@ -77,6 +94,7 @@ void Environment::MakeGameFromPython(int ourId)
     void Environment::MakeGameFromPython_frankfurt(bool agent0Alive, bool agent1Alive, bool agent2Alive, bool agent3Alive, uint8_t * board, double * bomb_life,
                                                    double * bomb_blast_strength, double * bomb_moving_direction, double * flame_life, int posx, int posy, int blast_strength, bool can_kick, int ammo, int game_type, int teammate_id, int message1, int message2)
     {
+        trace::Span span("MakeGameFromPython");
         util::TickFlames(*state);
         state->agents[0].bombCount = 0;
         state->agents[1].bombCount = 0;
@@ -183,7 +201,7 @@ void Environment::MakeGameFromPython(int ourId)
         {
             case FrankfurtMessageTypes::MaxBombCount1:
                 if(state->agents[state->teammateId].maxBombCount != message2) {
-                    std::cout << "Learned from message: maxBombCount: " << message2 << " (prev. assumed " << state->agents[state->teammateId].maxBombCount << ")" << std::endl;
+                    LogLearned(state.get(), log::MAX_BOMB_COUNT, message2, state->agents[state->teammateId].maxBombCount);
                     state->agents[state->teammateId].maxBombCount = message2;
                 }
                 break;
@@ -192,28 +210,28 @@ void Environment::MakeGameFromPython(int ourId)
                 bool enemy1CanKick = message2 % 4  > 1;
                 bool enemy2CanKick = message2  > 3;
                 if (state->agents[state->teammateId].canKick != teammateCanKick) {
-                    std::cout << "Learned from message: teammate canKick: " << teammateCanKick << " (prev. assumed " << state->agents[state->teammateId].canKick << ")" << std::endl;
+                    LogLearned(state.get(), log::TEAMMATE_CAN_KICK, teammateCanKick, state->agents[state->teammateId].canKick);
                     state->agents[state->teammateId].canKick = teammateCanKick;
                 }
                 if (state->agents[state->enemy1Id].canKick == false && enemy1CanKick) { //only accepting positive detection, because can't be sure
-                    std::cout << "Learned from message: enemy1 canKick: " << enemy1CanKick << " (prev. assumed " << state->agents[state->enemy1Id].canKick << ")" << std::endl;
+                    LogLearned(state.get(), log::ENEMY1_CAN_KICK, enemy1CanKick, state->agents[state->enemy1Id].canKick);
                     state->agents[state->enemy1Id].canKick = enemy1CanKick;
                 }
                 if (state->agents[state->enemy2Id].canKick == false && enemy2CanKick) { //only accepting positive detection, because can't be sure
-                    std::cout << "Learned from message: enemy2 canKick: " << enemy2CanKick << " (prev. assumed " << state->agents[state->enemy2Id].canKick << ")" << std::endl;
+                    LogLearned(state.get(), log::ENEMY2_CAN_KICK, enemy2CanKick, state->agents[state->enemy2Id].canKick);
                     state->agents[state->enemy2Id].canKick = enemy2CanKick;
                 }
                 break;
             }
             case FrankfurtMessageTypes::PositionX3:
                 if(state->agents[state->teammateId].x != message2) {
-                    std::cout << "Learned from message: x: " << message2 << " (prev. assumed " << state->agents[state->teammateId].x << ")" << std::endl;
+                    LogLearned(state.get(), log::POSITION_X, message2, state->agents[state->teammateId].x);
                     state->agents[state->teammateId].x = message2;
                 }
                 break;
             case FrankfurtMessageTypes::PositionY4:
                 if(state->agents[state->teammateId].y != message2) {
-                    std::cout << "Learned from message: y: " << message2 << " (prev. assumed " << state->agents[state->teammateId].y << ")" << std::endl;
+                    LogLearned(state.get(), log::POSITION_Y, message2, state->agents[state->teammateId].y);
                     state->agents[state->teammateId].y = message2;
                 }
                 break;
@@ -222,12 +240,12 @@ void Environment::MakeGameFromPython(int ourId)
                 break;
             case FrankfurtMessageTypes::BombStrength6:
                 if(state->agents[state->teammateId].bombStrength != message2) {
-                    std::cout << "Learned from message: BombStrength: " << message2 << " (prev. assumed " << state->agents[state->teammateId].bombStrength << ")" << std::endl;
+                    LogLearned(state.get(), log::BOMB_STRENGTH, message2, state->agents[state->teammateId].bombStrength);
                     state->agents[state->teammateId].bombStrength = message2;
                 }
                 break;
             case FrankfurtMessageTypes::ComeAround7:
-                std::cout << "Learned from message: ComeAround: " << message2 << std::endl;
+                LogLearned(state.get(), log::COME_AROUND, message2, 0);
                 state->comeAround = message2;
                 break;
         }
@@ -532,6 +550,7 @@ void Environment::MakeGameFromPython(int ourId)
     void Environment::MakeGameFromPython_gottingen(bool agent0Alive, bool agent1Alive, bool agent2Alive, bool agent3Alive, uint8_t * board, double * bomb_life,
                                                    double * bomb_blast_strength, double * bomb_moving_direction, double * flame_life, int posx, int posy, int blast_strength, bool can_kick, int ammo, int game_type, int teammate_id, int message1, int message2)
     {
+        trace::Span span("MakeGameFromPython");
         util::TickFlames(*state);
         state->agents[0].bombCount = 0;
         state->agents[1].bombCount = 0;
@@ -638,7 +657,7 @@ void Environment::MakeGameFromPython(int ourId)
         {
             case FrankfurtMessageTypes::MaxBombCount1:
                 if(state->agents[state->teammateId].maxBombCount != message2) {
-                    std::cout << "Learned from message: maxBombCount: " << message2 << " (prev. assumed " << state->agents[state->teammateId].maxBombCount << ")" << std::endl;
+                    LogLearned(state.get(), log::MAX_BOMB_COUNT, message2, state->agents[state->teammateId].maxBombCount);
                     state->agents[state->teammateId].maxBombCount = message2;
                 }
                 break;
@@ -647,28 +666,28 @@ void Environment::MakeGameFromPython(int ourId)
                 bool enemy1CanKick = message2 % 4  > 1;
                 bool enemy2CanKick = message2  > 3;
                 if (state->agents[state->teammateId].canKick != teammateCanKick) {
-                    std::cout << "Learned from message: teammate canKick: " << teammateCanKick << " (prev. assumed " << state->agents[state->teammateId].canKick << ")" << std::endl;
+                    LogLearned(state.get(), log::TEAMMATE_CAN_KICK, teammateCanKick, state->agents[state->teammateId].canKick);
                     state->agents[state->teammateId].canKick = teammateCanKick;
                 }
                 if (state->agents[state->enemy1Id].canKick == false && enemy1CanKick) { //only accepting positive detection, because can't be sure
-                    std::cout << "Learned from message: enemy1 canKick: " << enemy1CanKick << " (prev. assumed " << state->agents[state->enemy1Id].canKick << ")" << std::endl;
+                    LogLearned(state.get(), log::ENEMY1_CAN_KICK, enemy1CanKick, state->agents[state->enemy1Id].canKick);
                     state->agents[state->enemy1Id].canKick = enemy1CanKick;
                 }
                 if (state->agents[state->enemy2Id].canKick == false && enemy2CanKick) { //only accepting positive detection, because can't be sure
-                    std::cout << "Learned from message: enemy2 canKick: " << enemy2CanKick << " (prev. assumed " << state->agents[state->enemy2Id].canKick << ")" << std::endl;
+                    LogLearned(state.get(), log::ENEMY2_CAN_KICK, enemy2CanKick, state->agents[state->enemy2Id].canKick);
                     state->agents[state->enemy2Id].canKick = enemy2CanKick;
                 }
                 break;
             }
             case FrankfurtMessageTypes::PositionX3:
                 if(state->agents[state->teammateId].x != message2) {
-                    std::cout << "Learned from message: x: " << message2 << " (prev. assumed " << state->agents[state->teammateId].x << ")" << std::endl;
+                    LogLearned(state.get(), log::POSITION_X, message2, state->agents[state->teammateId].x);
                     state->agents[state->teammateId].x = message2;
                 }
                 break;
             case FrankfurtMessageTypes::PositionY4:
                 if(state->agents[state->teammateId].y != message2) {
-                    std::cout << "Learned from message: y: " << message2 << " (prev. assumed " << state->agents[state->teammateId].y << ")" << std::endl;
+                    LogLearned(state.get(), log::POSITION_Y, message2, state->agents[state->teammateId].y);
                     state->agents[state->teammateId].y = message2;
                 }
                 break;
@@ -677,12 +696,12 @@ void Environment::MakeGameFromPython(int ourId)
                 break;
             case FrankfurtMessageTypes::BombStrength6:
                 if(state->agents[state->teammateId].bombStrength != message2) {
-                    std::cout << "Learned from message: BombStrength: " << message2 << " (prev. assumed " << state->agents[state->teammateId].bombStrength << ")" << std::endl;
+                    LogLearned(state.get(), log::BOMB_STRENGTH, message2, state->agents[state->teammateId].bombStrength);
                     state->agents[state->teammateId].bombStrength = message2;
                 }
                 break;
             case FrankfurtMessageTypes::ComeAround7:
-                std::cout << "Learned from message: ComeAround: " << message2 << std::endl;
+                LogLearned(state.get(), log::COME_AROUND, message2, 0);
                 state->comeAround = message2;
                 break;
         }
@@ -992,19 +1011,22 @@ void Environment::StartGame(int timeSteps, bool render, bool stepByStep)
     {
 
         if(render)
-        {
             Print();
 
-            if(listener)
-                listener(*this);
+        if(listener)
+            listener(*this);
 
-            if(stepByStep)
-                Pause(false);
-        }
-        this->Step(true);
+        if(render && stepByStep)
+            Pause(false);
+
+        // headless games run as fast as the agents act
+        this->Step(render);
+    }
+    if(render)
+    {
+        Print();
+        PrintGameResult(*this);
     }
-    Print();
-    PrintGameResult(*this);
 }
 
 void ProxyAct(Move& writeBack, Agent& agent, State& state)
@@ -1047,7 +1069,8 @@ void Environment::Step(bool competitiveTimeLimit)
         return;
     }
 
-    Move m[AGENT_COUNT];
+    // the dead agents don't act, they stay idle
+    Move m[AGENT_COUNT] = {Move::IDLE, Move::IDLE, Move::IDLE, Move::IDLE};
 
 
     if(competitiveTimeLimit)
@@ -0,0 +1,162 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "hw_counters.hpp"
+
+namespace bboard::perf
+{
+
+Sample& Sample::operator+=(const Sample& other)
+{
+    for(int i = 0; i < COUNTER_COUNT; i++)
+        values[i] += other.values[i];
+    return *this;
+}
+
+Sample Sample::operator-(const Sample& other) const
+{
+    Sample s;
+    for(int i = 0; i < COUNTER_COUNT; i++)
+        s.values[i] = values[i] - other.values[i];
+    return s;
+}
+
+#ifdef __linux__
+
+namespace
+{
+
+int Open(uint32_t type, uint64_t config)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    // allowed with perf_event_paranoid <= 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+}
+
+HardwareCounters::HardwareCounters()
+{
+    const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D
+                                 | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds[CYCLES] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    if(fds[CYCLES] < 0)
+        error = errno;
+    fds[INSTRUCTIONS] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[L1D_MISSES] = Open(PERF_TYPE_HW_CACHE, l1dReadMiss);
+    fds[LLC_MISSES] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[BRANCH_MISSES] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+}
+
+HardwareCounters::~HardwareCounters()
+{
+    for(int fd : fds)
+        if(fd >= 0)
+            close(fd);
+}
+
+Sample HardwareCounters::Read() const
+{
+    Sample s;
+    for(int i = 0; i < COUNTER_COUNT; i++)
+    {
+        uint64_t value;
+        if(fds[i] >= 0 && read(fds[i], &value, sizeof(value)) == sizeof(value))
+            s.values[i] = value;
+    }
+    return s;
+}
+
+#else
+
+HardwareCounters::HardwareCounters()
+{
+    for(int& fd : fds)
+        fd = -1;
+    error = ENOSYS;
+}
+
+HardwareCounters::~HardwareCounters() {}
+
+Sample HardwareCounters::Read() const
+{
+    return Sample();
+}
+
+#endif
+
+bool HardwareCounters::Available() const
+{
+    return fds[CYCLES] >= 0 && fds[INSTRUCTIONS] >= 0;
+}
+
+bool HardwareCounters::Has(Counter c) const
+{
+    return fds[c] >= 0;
+}
+
+const char* HardwareCounters::Error() const
+{
+    if(Available())
+        return "";
+    return error != 0 ? std::strerror(error) : "instructions are not counted";
+}
+
+HardwareCounters& ThreadCounters()
+{
+    thread_local HardwareCounters counters;
+    return counters;
+}
+
+bool Enabled()
+{
+    static const bool enabled = [] {
+        const char* e = std::getenv("POMMERMAN_HW_COUNTERS");
+        return e && std::atoi(e) != 0;
+    }();
+    return enabled;
+}
+
+void Report(std::ostream& out, const char* what, const Sample& sample, int64_t steps)
+{
+    const HardwareCounters& counters = ThreadCounters();
+    if(!counters.Available())
+    {
+        out << what << ": hardware counters are unavailable (" << counters.Error() << ")" << std::endl;
+        return;
+    }
+
+    const double perStep = steps > 0 ? 1.0 / steps : 0.0;
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2) << what << ": IPC "
+        << (sample.values[CYCLES] > 0 ? sample.values[INSTRUCTIONS] / (double)sample.values[CYCLES] : 0.0)
+        << ", per step: " << sample.values[CYCLES] * perStep << " cycles, "
+        << sample.values[INSTRUCTIONS] * perStep << " instructions";
+    if(counters.Has(L1D_MISSES))
+        out << ", " << sample.values[L1D_MISSES] * perStep << " L1D misses";
+    if(counters.Has(LLC_MISSES))
+        out << ", " << sample.values[LLC_MISSES] * perStep << " LLC misses";
+    if(counters.Has(BRANCH_MISSES))
+        out << ", " << sample.values[BRANCH_MISSES] * perStep << " branch misses";
+    out << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+}
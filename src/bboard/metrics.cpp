@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "metrics.hpp"
+
+namespace bboard::metrics
+{
+
+Histogram::Histogram(std::initializer_list<double> upperBounds)
+{
+    for(double b : upperBounds)
+    {
+        if(boundCount < MAX_BOUNDS)
+            bounds[boundCount++] = b;
+    }
+}
+
+void Histogram::Observe(double value)
+{
+    int i = 0;
+    while(i < boundCount && value > bounds[i])
+        i++;
+    buckets[i].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    double old = sum.load(std::memory_order_relaxed);
+    while(!sum.compare_exchange_weak(old, old + value, std::memory_order_relaxed)) {}
+}
+
+void Histogram::Write(std::ostream& out, const char* name) const
+{
+    uint64_t cumulative = 0;
+    for(int i = 0; i <= boundCount; i++)
+    {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        out << name << "_bucket{le=\"";
+        if(i < boundCount)
+            out << bounds[i];
+        else
+            out << "+Inf";
+        out << "\"} " << cumulative << "\n";
+    }
+    out << name << "_sum " << sum.load(std::memory_order_relaxed) << "\n";
+    out << name << "_count " << count.load(std::memory_order_relaxed) << "\n";
+}
+
+namespace
+{
+
+void WriteCounter(std::ostream& out, const char* name, const char* help, const Counter& c)
+{
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " counter\n"
+        << name << " " << c.Value() << "\n";
+}
+
+void WriteHistogram(std::ostream& out, const char* name, const char* help, const Histogram& h)
+{
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " histogram\n";
+    h.Write(out, name);
+}
+
+void WriteAll(std::ostream& out, const AgentMetrics& a)
+{
+    WriteCounter(out, "pommerman_turns_total", "Turns of the search agents", a.turns);
+    WriteCounter(out, "pommerman_overtime_turns_total", "Turns longer than the time limit", a.overtimes);
+    WriteCounter(out, "pommerman_nodes_total", "Simulated steps of the searches", a.nodes);
+    WriteCounter(out, "pommerman_rollouts_total", "Leaves scored after a rollout of the planted bombs", a.rollouts);
+    WriteCounter(out, "pommerman_rollout_ticks_total", "Bomb ticks simulated in the rollouts", a.rolloutTicks);
+    WriteCounter(out, "pommerman_scene_cache_lookups_total", "Lookups in the scene hash memory", a.sceneLookups);
+    WriteCounter(out, "pommerman_scene_cache_hits_total", "Scenes skipped because they were already simulated", a.sceneHits);
+    WriteHistogram(out, "pommerman_turn_seconds", "Time of a turn, from the observation to the move", a.turnSeconds);
+    WriteHistogram(out, "pommerman_nodes_per_second", "Simulated steps per second of the searches", a.nodesPerSecond);
+    WriteHistogram(out, "pommerman_search_depth", "Depth of the searches", a.depth);
+}
+
+/**
+ * Rewrites the metrics file periodically, and once more at exit
+ */
+class Exporter
+{
+public:
+    explicit Exporter(const AgentMetrics& metrics) : metrics(metrics)
+    {
+        const char* p = std::getenv("POMMERMAN_METRICS_FILE");
+        if(!p)
+            return;
+        path = p;
+        const char* interval = std::getenv("POMMERMAN_METRICS_INTERVAL_MS");
+        intervalMillis = interval ? std::max(100, std::atoi(interval)) : 5000;
+        worker = std::thread(&Exporter::Run, this);
+    }
+
+    ~Exporter()
+    {
+        if(!worker.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+private:
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        bool last = false;
+        while(!last)
+        {
+            last = cv.wait_for(lock, std::chrono::milliseconds(intervalMillis), [this] { return quit; });
+
+            // the scraper never sees a half written file
+            const std::string tmp = path + ".tmp";
+            {
+                std::ofstream out(tmp);
+                out.precision(12);
+                WriteAll(out, metrics);
+                if(!out)
+                {
+                    std::cout << "Couldn't write the metrics " << tmp << std::endl;
+                    continue;
+                }
+            }
+            std::rename(tmp.c_str(), path.c_str());
+        }
+    }
+
+    const AgentMetrics& metrics;
+    std::string path;
+    int intervalMillis = 5000;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool quit = false;
+};
+
+}
+
+AgentMetrics& Agents()
+{
+    static AgentMetrics agents;
+    // after the metrics, so that it is destroyed (and writes the last time) before them
+    static Exporter exporter(agents);
+    return agents;
+}
+
+void Write(std::ostream& out)
+{
+    WriteAll(out, Agents());
+}
+
+}
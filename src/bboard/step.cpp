@@ -2,28 +2,34 @@
 
 #include "bboard.hpp"
 #include "step_utility.hpp"
+#include "step_profile.hpp"
 
 namespace bboard
 {
 
 bool Step(State* state, Move* moves)
 {
+    STEP_PROFILE_SCOPE(STEP);
 
     ///////////////////
     //    Flames     //
     ///////////////////
+    STEP_PROFILE_BEGIN(TICK_FLAMES);
     util::TickFlames(*state);
+    STEP_PROFILE_END(TICK_FLAMES);
 
     ///////////////////////
     //  Player Movement  //
     ///////////////////////
 
+    STEP_PROFILE_BEGIN(DESTINATIONS);
     Position oldPos[AGENT_COUNT];
     Position destPos[AGENT_COUNT];
 
     util::FillPositions(state, oldPos);
     util::FillDestPos(state, moves, destPos);
     bool any_switch = util::FixSwitchMove(state, destPos);
+    STEP_PROFILE_END(DESTINATIONS);
     // if all the agents successfully moved to their (initial) destination
     bool agentMoveSuccess = !any_switch;
 
@@ -31,8 +37,14 @@ bool Step(State* state, Move* moves)
     int roots[AGENT_COUNT] = {-1, -1, -1, -1};
 
     // the amount of chain roots
+    STEP_PROFILE_BEGIN(DEPENDENCIES);
     const int rootNumber = util::ResolveDependencies(state, destPos, dependency, roots);
+    STEP_PROFILE_END(DEPENDENCIES);
     const bool ouroboros = rootNumber == 0; // ouroboros formation?
+    if(ouroboros)
+        STEP_PROFILE_EVENT(OUROBOROS);
+
+    STEP_PROFILE_BEGIN(AGENT_MOVES);
 
     int rootIdx = 0;
     int i = rootNumber == 0 ? 0 : roots[0]; // no roots -> start from 0
@@ -214,6 +226,7 @@ bool Step(State* state, Move* moves)
             state->agents[i].x = desired.x;
             state->agents[i].y = desired.y;
 
+            STEP_PROFILE_EVENT(KICK);
             // start moving the kicked bomb by setting a velocity
             // the first 5 values of Move and Direction are semantically identical
             Bomb& b = *state->GetBomb(desired.x,  desired.y);
@@ -237,7 +250,10 @@ bool Step(State* state, Move* moves)
         }
     }
 
+    STEP_PROFILE_END(AGENT_MOVES);
+
     // Before moving bombs, reset their "moved" flags
+    STEP_PROFILE_BEGIN(BOMB_STOPS);
     util::ResetBombFlags(*state);
 
     // Fill array of desired positions
@@ -268,7 +284,7 @@ bool Step(State* state, Move* moves)
                     && !(state->agents[indexAgent].GetPos() == oldPos[indexAgent]))
 
             {
-
+                STEP_PROFILE_SCOPE(CHAIN_REVERSION);
                 util::AgentBombChainReversion(*state, moves, bombDestinations, indexAgent);
                 if(state->GetAgent(bx, by) == -1)
                 {
@@ -280,7 +296,10 @@ bool Step(State* state, Move* moves)
 
     }
 
+    STEP_PROFILE_END(BOMB_STOPS);
+
     // Move bombs
+    STEP_PROFILE_BEGIN(BOMB_MOVES);
     for(int i = 0; i < state->bombs.count; i++)
     {
         Bomb& b = state->bombs[i];
@@ -289,6 +308,7 @@ bool Step(State* state, Move* moves)
         {
             if(util::HasBombCollision(*state, b, i))
             {
+                STEP_PROFILE_EVENT(BOMB_COLLISION);
                 util::ResolveBombCollision(*state, moves, bombDestinations, i);
                 continue;
             }
@@ -304,6 +324,7 @@ bool Step(State* state, Move* moves)
         {
             if(util::HasBombCollision(*state, b, i))
             {
+                STEP_PROFILE_EVENT(BOMB_COLLISION);
                 util::ResolveBombCollision(*state, moves, bombDestinations, i);
                 continue;
             }
@@ -322,6 +343,7 @@ bool Step(State* state, Move* moves)
             }
             else if(IS_FLAME(tItem))
             {
+                STEP_PROFILE_EVENT(BOMB_INTO_FLAME);
                 state->ExplodeBombAt(state->GetBombIndex(target.x, target.y));
             }
         }
@@ -331,10 +353,14 @@ bool Step(State* state, Move* moves)
         }
     }
 
+    STEP_PROFILE_END(BOMB_MOVES);
+
     ///////////////
     // Explosion //
     ///////////////
+    STEP_PROFILE_BEGIN(EXPLOSIONS);
     util::TickBombs(*state);
+    STEP_PROFILE_END(EXPLOSIONS);
 
     return agentMoveSuccess;
 }
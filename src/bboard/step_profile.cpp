@@ -0,0 +1,104 @@
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "step_profile.hpp"
+
+namespace bboard::profile
+{
+
+namespace
+{
+
+std::mutex registryMutex;
+// never freed, the counters of a finished thread are still reported
+std::vector<std::unique_ptr<Counters>> registry;
+
+#ifdef STEP_PROFILE
+const char* phaseNames[PHASE_COUNT] =
+{
+    "Step", "TickFlames", "destinations", "ResolveDependencies", "agent moves",
+    "bomb stops", "  chain reversion", "bomb moves", "explosions"
+};
+
+const char* eventNames[EVENT_COUNT] =
+{
+    "ouroboros", "kicks", "bomb collisions", "bombs into flames"
+};
+#endif
+
+}
+
+Counters& ThreadCounters()
+{
+    thread_local Counters* counters = nullptr;
+    if(!counters)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<Counters>());
+        counters = registry.back().get();
+        *counters = Counters();
+    }
+    return *counters;
+}
+
+void Report(std::ostream& out)
+{
+#ifndef STEP_PROFILE
+    out << "The Step profile is not compiled in (build with -DSTEP_PROFILE)" << std::endl;
+#else
+    Counters total = Counters();
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for(const auto& c : registry)
+        {
+            for(int i = 0; i < PHASE_COUNT; i++)
+            {
+                total.calls[i] += c->calls[i];
+                total.cycles[i] += c->cycles[i];
+            }
+            for(int i = 0; i < EVENT_COUNT; i++)
+                total.events[i] += c->events[i];
+        }
+    }
+
+    // the caller's stream settings are restored at the end
+    const std::ios::fmtflags flags = out.flags();
+    const char fill = out.fill(' ');
+    const std::streamsize precision = out.precision();
+    const double stepCycles = total.cycles[STEP] > 0 ? (double)total.cycles[STEP] : 1.0;
+    const double steps = total.calls[STEP] > 0 ? (double)total.calls[STEP] : 1.0;
+    out << std::endl << "Step phases:" << std::endl
+        << std::left << std::setw(22) << "phase" << std::right
+        << std::setw(14) << "calls" << std::setw(16) << "cycles"
+        << std::setw(14) << "cycles/call" << std::setw(10) << "% step" << std::endl;
+    for(int i = 0; i < PHASE_COUNT; i++)
+    {
+        const double perCall = total.calls[i] > 0 ? total.cycles[i] / (double)total.calls[i] : 0.0;
+        out << std::left << std::setw(22) << phaseNames[i] << std::right
+            << std::setw(14) << total.calls[i] << std::setw(16) << total.cycles[i]
+            << std::setw(14) << std::fixed << std::setprecision(1) << perCall
+            << std::setw(10) << 100.0 * total.cycles[i] / stepCycles << std::endl;
+    }
+    out << std::endl << "Step events:" << std::endl;
+    for(int i = 0; i < EVENT_COUNT; i++)
+    {
+        out << std::left << std::setw(22) << eventNames[i] << std::right
+            << std::setw(14) << total.events[i]
+            << std::setw(14) << std::setprecision(4) << total.events[i] / steps << " per step" << std::endl;
+    }
+    out.flags(flags);
+    out.fill(fill);
+    out.precision(precision);
+#endif
+}
+
+void Reset()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for(auto& c : registry)
+        *c = Counters();
+}
+
+}
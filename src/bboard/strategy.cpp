@@ -248,6 +248,394 @@ int IsInDanger(const State& state, int x, int y)
     return minTime;
 }
 
+///////////////////
+// Escape Oracle //
+///////////////////
+
+inline void RecordScheduleStep(const State& s, FlameSchedule& fs, int t)
+{
+    const FlameTicks bit = FlameTicks(1 << t);
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            const int item = s.board[y][x];
+            if(IS_FLAME(item))
+            {
+                fs.burning[y][x] |= bit;
+            }
+            else if(item == Item::RIGID || IS_WOOD(item))
+            {
+                fs.blocked[y][x] |= bit;
+            }
+        }
+    }
+    // bombs are taken from the queue, the board doesn't show bombs under agents
+    for(int i = 0; i < s.bombs.count; i++)
+    {
+        fs.bombs[BMB_POS_Y(s.bombs[i])][BMB_POS_X(s.bombs[i])] |= bit;
+    }
+}
+
+/**
+ * @brief SimulateFlameSchedule Same as FillFlameSchedule, but uses up
+ * the given state instead of copying it
+ */
+void SimulateFlameSchedule(State& sim, FlameSchedule& fs)
+{
+    std::fill(fs.burning[0], fs.burning[0] + BOARD_SIZE * BOARD_SIZE, 0);
+    std::fill(fs.blocked[0], fs.blocked[0] + BOARD_SIZE * BOARD_SIZE, 0);
+    std::fill(fs.bombs[0], fs.bombs[0] + BOARD_SIZE * BOARD_SIZE, 0);
+
+    RecordScheduleStep(sim, fs, 0);
+    fs.horizon = 0;
+    for(int t = 1; t <= FLAME_HORIZON && (sim.bombs.count > 0 || sim.flames.count > 0); t++)
+    {
+        util::TickFlames(sim);
+        util::TickAndMoveBombs(sim);
+        RecordScheduleStep(sim, fs, t);
+        fs.horizon = t;
+    }
+}
+
+void FillFlameSchedule(const State& s, FlameSchedule& fs)
+{
+    State sim(s);
+    SimulateFlameSchedule(sim, fs);
+}
+
+bool CanEscape(const FlameSchedule& fs, int x, int y, int tick, bool canKick)
+{
+    if(util::IsOutOfBounds(x, y) || ((fs.burning[y][x] >> tick) & 1))
+    {
+        return false;
+    }
+
+    Position frontier[2][BOARD_SIZE * BOARD_SIZE];
+    int count[2] = {1, 0};
+    frontier[0][0] = {x, y};
+
+    const int dx[5] = {0, 1, -1, 0, 0};
+    const int dy[5] = {0, 0, 0, 1, -1};
+
+    for(int t = tick, cur = 0; count[cur] > 0; t++, cur = 1 - cur)
+    {
+        // a cell that never burns again is a safe place to wait
+        for(int i = 0; i < count[cur]; i++)
+        {
+            const Position& p = frontier[cur][i];
+            if((fs.burning[p.y][p.x] >> (t + 1)) == 0)
+            {
+                return true;
+            }
+        }
+
+        const FlameTicks now = FlameTicks(1 << t);
+        const FlameTicks next = FlameTicks(1 << (t + 1));
+        bool seen[BOARD_SIZE][BOARD_SIZE] = {};
+        int& nextCount = count[1 - cur];
+        nextCount = 0;
+
+        for(int i = 0; i < count[cur]; i++)
+        {
+            const Position& p = frontier[cur][i];
+            for(int d = 0; d < 5; d++)
+            {
+                const int nx = p.x + dx[d];
+                const int ny = p.y + dy[d];
+                if(util::IsOutOfBounds(nx, ny) || seen[ny][nx] || (fs.burning[ny][nx] & next))
+                {
+                    continue;
+                }
+                // staying is always possible, even on our own bomb
+                if(d > 0 && ((fs.blocked[ny][nx] & now) || (!canKick && (fs.bombs[ny][nx] & now))))
+                {
+                    continue;
+                }
+                seen[ny][nx] = true;
+                frontier[1 - cur][nextCount++] = {nx, ny};
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief _CheckMoveTarget The same check the search agents use
+ * to decide if a move is possible
+ */
+inline bool _CheckMoveTarget(const State& state, int x, int y, bool canKick)
+{
+    return !util::IsOutOfBounds(x, y) &&
+           (IS_WALKABLE_OR_AGENT(state.board[y][x]) || (canKick && state.board[y][x] == Item::BOMB));
+}
+
+/**
+ * @brief _IsKick A move of a kicker onto a bomb. The flame schedule
+ * doesn't know where the kicked bomb goes, only the search simulates it.
+ */
+inline bool _IsKick(const State& state, const AgentInfo& a, int move)
+{
+    if(move == int(Move::IDLE) || move == int(Move::BOMB) || !a.canKick)
+    {
+        return false;
+    }
+    const Position p = util::DesiredPosition(a.x, a.y, Move(move));
+    return !util::IsOutOfBounds(p.x, p.y) && state.HasBomb(p.x, p.y);
+}
+
+int SafeMoves(const State& state, int agentID, bool safe[6])
+{
+    std::fill(safe, safe + 6, false);
+
+    const AgentInfo& a = state.agents[agentID];
+    if(a.dead || a.x < 0)
+    {
+        return 0;
+    }
+
+    FlameSchedule fs;
+    FillFlameSchedule(state, fs);
+
+    int count = 0;
+    for(int m = int(Move::IDLE); m <= int(Move::RIGHT); m++)
+    {
+        Position p = util::DesiredPosition(a.x, a.y, Move(m));
+        if(m != int(Move::IDLE) && !_CheckMoveTarget(state, p.x, p.y, a.canKick))
+        {
+            continue;
+        }
+        // the board doesn't show bombs under other agents
+        if(m != int(Move::IDLE) && !a.canKick && state.HasBomb(p.x, p.y))
+        {
+            continue;
+        }
+        // a kick may carry the threatening bomb away
+        if(_IsKick(state, a, m))
+        {
+            safe[m] = true;
+            count++;
+            continue;
+        }
+        safe[m] = CanEscape(fs, p.x, p.y, 1, a.canKick);
+        count += safe[m];
+    }
+
+    if(a.maxBombCount - a.bombCount > 0 && !state.HasBomb(a.x, a.y))
+    {
+        // the bomb is planted the same way as in Step
+        State withBomb(state);
+        withBomb.PlantBombModifiedLife(a.x, a.y, agentID, BOMB_LIFETIME + 1);
+        SimulateFlameSchedule(withBomb, fs);
+        safe[int(Move::BOMB)] = CanEscape(fs, a.x, a.y, 1, a.canKick);
+        count += safe[int(Move::BOMB)];
+    }
+    return count;
+}
+
+bool ForcedEscapeMove(const State& state, int agentID, Move& move)
+{
+    bool safe[6];
+    if(SafeMoves(state, agentID, safe) != 1)
+    {
+        return false;
+    }
+    for(int m = 0; m < 6; m++)
+    {
+        if(safe[m])
+        {
+            // only a guess, the search has to judge the kick
+            if(_IsKick(state, state.agents[agentID], m))
+            {
+                return false;
+            }
+            move = Move(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+/////////////////
+// Kill Solver //
+/////////////////
+
+struct KillSearch
+{
+    int agentID;
+    int targetID;
+    const std::atomic<bool>* stop;
+    int& nodes;
+    int maxNodes;
+    bool aborted = false;
+};
+
+/**
+ * @brief AttackerMoves Fills the moves worth trying for a kill: bombs,
+ * kicks, moves towards the target and IDLE. Moves without an escape are
+ * left out (unless all moves are doomed).
+ */
+int AttackerMoves(const State& state, const KillSearch& ks, Move moves[6])
+{
+    const AgentInfo& a = state.agents[ks.agentID];
+    const AgentInfo& t = state.agents[ks.targetID];
+    const int distance = std::abs(a.x - t.x) + std::abs(a.y - t.y);
+
+    bool safe[6];
+    const bool anySafe = SafeMoves(state, ks.agentID, safe) > 0;
+
+    int count = 0;
+    for(int m = int(Move::BOMB); m >= int(Move::IDLE); m--)
+    {
+        if(anySafe && !safe[m])
+        {
+            continue;
+        }
+        if(m == int(Move::BOMB))
+        {
+            if(a.maxBombCount - a.bombCount <= 0 || state.HasBomb(a.x, a.y))
+            {
+                continue;
+            }
+        }
+        else if(m != int(Move::IDLE))
+        {
+            Position p = util::DesiredPosition(a.x, a.y, Move(m));
+            if(!_CheckMoveTarget(state, p.x, p.y, a.canKick))
+            {
+                continue;
+            }
+            const bool kick = state.board[p.y][p.x] == Item::BOMB;
+            if(!kick && std::abs(p.x - t.x) + std::abs(p.y - t.y) >= distance)
+            {
+                continue;
+            }
+        }
+        moves[count++] = Move(m);
+    }
+    return count;
+}
+
+/**
+ * @brief TargetMoves Fills every legal move of the target
+ */
+int TargetMoves(const State& state, int targetID, Move moves[6])
+{
+    const AgentInfo& t = state.agents[targetID];
+    int count = 0;
+    moves[count++] = Move::IDLE;
+    for(int m = int(Move::UP); m <= int(Move::RIGHT); m++)
+    {
+        Position p = util::DesiredPosition(t.x, t.y, Move(m));
+        if(_CheckMoveTarget(state, p.x, p.y, t.canKick))
+        {
+            moves[count++] = Move(m);
+        }
+    }
+    if(t.maxBombCount - t.bombCount > 0 && !state.HasBomb(t.x, t.y))
+    {
+        moves[count++] = Move::BOMB;
+    }
+    return count;
+}
+
+/**
+ * @brief IsKillProven The target is dead or doomed and we still
+ * have a way out
+ */
+inline bool IsKillProven(const State& state, const KillSearch& ks)
+{
+    if(state.agents[ks.agentID].dead)
+    {
+        return false;
+    }
+    if(state.agents[ks.targetID].dead)
+    {
+        return true;
+    }
+    bool safe[6];
+    return SafeMoves(state, ks.targetID, safe) == 0 && SafeMoves(state, ks.agentID, safe) > 0;
+}
+
+/**
+ * @brief SearchKill AND-OR search: one of our moves has to work
+ * against all of the target's moves
+ */
+bool SearchKill(const State& state, KillSearch& ks, int depth, Move* firstMove)
+{
+    if(ks.aborted || ++ks.nodes > ks.maxNodes || (ks.stop && ks.stop->load(std::memory_order_relaxed)))
+    {
+        ks.aborted = true;
+        return false;
+    }
+
+    Move ours[6], theirs[6];
+    const int ourCount = AttackerMoves(state, ks, ours);
+    const int theirCount = TargetMoves(state, ks.targetID, theirs);
+
+    Move moves[AGENT_COUNT] = {Move::IDLE, Move::IDLE, Move::IDLE, Move::IDLE};
+    for(int i = 0; i < ourCount; i++)
+    {
+        moves[ks.agentID] = ours[i];
+
+        bool refuted = false;
+        for(int j = 0; j < theirCount && !refuted; j++)
+        {
+            moves[ks.targetID] = theirs[j];
+
+            State next(state);
+            next.relTimeStep++;
+            Step(&next, moves);
+
+            if(IsKillProven(next, ks))
+            {
+                continue;
+            }
+            refuted = next.agents[ks.agentID].dead || depth <= 1 ||
+                      !SearchKill(next, ks, depth - 1, nullptr);
+        }
+
+        if(ks.aborted)
+        {
+            return false;
+        }
+        if(!refuted)
+        {
+            if(firstMove)
+            {
+                *firstMove = ours[i];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+int ProveKill(const State& state, int agentID, int targetID, int maxDepth, Move& move,
+              const std::atomic<bool>* stop, int& nodes, int maxNodes)
+{
+    const AgentInfo& a = state.agents[agentID];
+    const AgentInfo& t = state.agents[targetID];
+    if(a.dead || t.dead || a.x < 0 || t.x < 0)
+    {
+        return 0;
+    }
+
+    KillSearch ks{agentID, targetID, stop, nodes, maxNodes};
+    for(int depth = 1; depth <= maxDepth; depth++)
+    {
+        if(SearchKill(state, ks, depth, &move))
+        {
+            return depth;
+        }
+        if(ks.aborted)
+        {
+            break;
+        }
+    }
+    return 0;
+}
+
 void PrintMap(RMap &r)
 {
     std::string res = "";
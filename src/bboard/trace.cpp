@@ -0,0 +1,217 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace bboard::trace
+{
+
+std::atomic<int> level{0};
+
+namespace
+{
+
+struct Event
+{
+    const char* name;
+    int64_t begin;
+    int64_t end;
+    int arg;
+    int thread;
+    int agent;
+};
+
+/**
+ * Every thread appends to its own buffer, the lock is only
+ * contended while the events are collected at the end of a turn
+ */
+struct Buffer
+{
+    std::mutex mutex;
+    std::vector<Event> events;
+    int thread;
+};
+
+struct Tracer
+{
+    std::mutex mutex;
+    // never freed, a thread may exit before its events are written
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    // the events of the unfinished episodes
+    std::vector<Event> episode;
+    std::string prefix;
+    bool perEpisode = false;
+    int episodes[4] = {0, 0, 0, 0};
+
+    Tracer()
+    {
+        if(const char* p = std::getenv("POMMERMAN_TRACE"))
+        {
+            prefix = p;
+            const char* l = std::getenv("POMMERMAN_TRACE_LEVEL");
+            const char* e = std::getenv("POMMERMAN_TRACE_EPISODE");
+            perEpisode = e && std::atoi(e) != 0;
+            level = l ? std::atoi(l) : 1;
+        }
+    }
+};
+
+Tracer& GetTracer()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+const auto processStart = std::chrono::steady_clock::now();
+
+thread_local int currentAgent = -1;
+
+// reads the environment before main
+const Tracer& initialized = GetTracer();
+
+Buffer& ThreadBuffer()
+{
+    thread_local Buffer* buffer = nullptr;
+    if(!buffer)
+    {
+        Tracer& t = GetTracer();
+        std::lock_guard<std::mutex> lock(t.mutex);
+        t.buffers.push_back(std::make_unique<Buffer>());
+        buffer = t.buffers.back().get();
+        buffer->thread = (int)t.buffers.size() - 1;
+        buffer->events.reserve(1024);
+    }
+    return *buffer;
+}
+
+void WriteJSON(const std::string& path, const std::vector<Event>& events, int agentId)
+{
+    std::ofstream out(path);
+    if(!out)
+    {
+        std::cout << "Couldn't write the trace " << path << std::endl;
+        return;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << agentId
+        << ",\"args\":{\"name\":\"agent " << agentId << "\"}}";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for(const Event& e : events)
+    {
+        out << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":" << agentId
+            << ",\"tid\":" << e.thread << ",\"ts\":" << e.begin / 1000.0
+            << ",\"dur\":" << (e.end - e.begin) / 1000.0;
+        if(e.arg >= 0)
+            out << ",\"args\":{\"arg\":" << e.arg << "}";
+        out << "}";
+    }
+    out << "\n]}\n";
+}
+
+}
+
+int64_t Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - processStart).count();
+}
+
+void Record(const char* name, int64_t begin, int64_t end, int arg)
+{
+    Buffer& b = ThreadBuffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.events.push_back({name, begin, end, arg, b.thread, currentAgent});
+}
+
+void SetAgent(int agentId)
+{
+    currentAgent = agentId;
+}
+
+void Configure(int level, const std::string& prefix, bool perEpisode)
+{
+    Tracer& t = GetTracer();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    t.prefix = prefix;
+    t.perEpisode = perEpisode;
+    trace::level = level;
+}
+
+void EndTurn(int agentId, int timeStep)
+{
+    if(level.load(std::memory_order_relaxed) <= 0)
+        return;
+
+    Tracer& t = GetTracer();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    std::vector<Event> turn;
+    for(auto& b : t.buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(b->mutex);
+        // the events of the other agents wait for the end of their turns
+        size_t kept = 0;
+        for(Event& e : b->events)
+        {
+            if(e.agent == agentId || e.agent < 0)
+            {
+                e.agent = agentId;
+                turn.push_back(e);
+            }
+            else
+                b->events[kept++] = e;
+        }
+        b->events.resize(kept);
+    }
+
+    if(t.perEpisode)
+        t.episode.insert(t.episode.end(), turn.begin(), turn.end());
+    else
+        WriteJSON(t.prefix + ".agent" + std::to_string(agentId) + ".turn" + std::to_string(timeStep) + ".json",
+                  turn, agentId);
+}
+
+void EndEpisode(int agentId)
+{
+    if(level.load(std::memory_order_relaxed) <= 0)
+        return;
+
+    Tracer& t = GetTracer();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    if(!t.perEpisode)
+        return;
+
+    // the teammate's events are kept for its own episode end
+    std::vector<Event> mine, others;
+    for(const Event& e : t.episode)
+        (e.agent == agentId ? mine : others).push_back(e);
+    t.episode.swap(others);
+
+    const int episode = agentId >= 0 && agentId < 4 ? t.episodes[agentId]++ : 0;
+    WriteJSON(t.prefix + ".agent" + std::to_string(agentId) + ".episode" + std::to_string(episode) + ".json",
+              mine, agentId);
+}
+
+std::map<std::string, int64_t> TakeTotals(int agentId)
+{
+    std::map<std::string, int64_t> totals;
+    Tracer& t = GetTracer();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    std::vector<Event> others;
+    for(const Event& e : t.episode)
+    {
+        if(e.agent == agentId)
+            totals[e.name] += e.end - e.begin;
+        else
+            others.push_back(e);
+    }
+    t.episode.swap(others);
+    return totals;
+}
+
+}
@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "search_tree.hpp"
+
+using agents::tree::Header;
+using agents::tree::Node;
+
+/**
+ * Analyzes a search tree dumped with POMMERMAN_TREE_DUMP:
+ *  - nodes, effective branching factor and legal moves per depth
+ *  - subtrees which could have been pruned without changing the root decision
+ *  - the most expensive subtrees
+ *
+ * Usage: analyze_search_tree <file> [number of expensive subtrees]
+ */
+
+struct Tree
+{
+    Header header;
+    std::vector<Node> nodes;
+    std::vector<std::vector<int>> children;
+    std::vector<int> parent;
+    std::vector<int> rootChildren;
+};
+
+const float NOT_SEARCHED = -10000.0f;
+
+/**
+ * The points of the own moves, the way SearchAgent::runOneStep
+ * combines its children: the best teammate reply against the worst
+ * enemy replies, plus the weighted average of the enemy replies.
+ * The children come in the order of the nested loops, so a group of a
+ * loop is a run of children with the same moves of the outer loops.
+ */
+void OwnMovePoints(const Tree& t, const std::vector<int>& children, const std::vector<float>& value,
+                   const std::vector<char>& pruned, float points[6])
+{
+    for(int m = 0; m < 6; m++)
+        points[m] = NOT_SEARCHED;
+
+    size_t i = 0;
+    while(i < children.size())
+    {
+        const int own = t.nodes[children[i]].moves[0];
+        float maxTeammate = -100;
+        float futureStepsT = 0.0f;
+        while(i < children.size() && t.nodes[children[i]].moves[0] == own)
+        {
+            const int teammate = t.nodes[children[i]].moves[1];
+            float Eavg = 0.0f;
+            int Eavg_count = 0;
+            float minPointE1 = 100;
+            float futureStepsE1 = 0.0f;
+            while(i < children.size() && t.nodes[children[i]].moves[0] == own
+                    && t.nodes[children[i]].moves[1] == teammate)
+            {
+                const int enemy1 = t.nodes[children[i]].moves[2];
+                float minPointE2 = 100;
+                float futureStepsE2 = 0.0f;
+                while(i < children.size() && t.nodes[children[i]].moves[0] == own
+                        && t.nodes[children[i]].moves[1] == teammate && t.nodes[children[i]].moves[2] == enemy1)
+                {
+                    const int c = children[i++];
+                    if(pruned[c])
+                        continue;
+                    const float v = value[c];
+                    Eavg += v;
+                    Eavg_count++;
+                    if(v > -100 && v < minPointE2)
+                    {
+                        minPointE2 = v;
+                        futureStepsE2 = v;
+                    }
+                }
+                if(minPointE2 > -100 && minPointE2 < minPointE1)
+                {
+                    minPointE1 = minPointE2;
+                    futureStepsE1 = futureStepsE2;
+                }
+            }
+            if(minPointE1 < 100 && minPointE1 > maxTeammate)
+            {
+                maxTeammate = minPointE1;
+                futureStepsT = futureStepsE1;
+            }
+            Eavg = Eavg_count ? Eavg / (float)Eavg_count : Eavg;
+            futureStepsT += Eavg * t.header.averageWeight;
+            maxTeammate += Eavg * t.header.averageWeight;
+        }
+        if(maxTeammate > -100)
+            points[own] = futureStepsT;
+    }
+}
+
+float Best(const float points[6])
+{
+    return *std::max_element(points, points + 6);
+}
+
+/**
+ * The values of the inner nodes recomputed from their children
+ */
+std::vector<float> Recompute(const Tree& t, const std::vector<char>& pruned, int& mismatches)
+{
+    std::vector<float> value(t.nodes.size());
+    mismatches = 0;
+    for(size_t i = 0; i < t.nodes.size(); i++)
+    {
+        if(t.children[i].empty())
+        {
+            value[i] = t.nodes[i].value;
+            continue;
+        }
+        float points[6];
+        OwnMovePoints(t, t.children[i], value, pruned, points);
+        value[i] = Best(points);
+        if(std::abs(value[i] - t.nodes[i].value) > 1e-3f)
+            mismatches++;
+    }
+    return value;
+}
+
+/**
+ * @brief Prunable Would the root decision stay the same without the node
+ * (and its subtree)? The values of its ancestors are recomputed for this
+ * and restored at the end.
+ */
+bool Prunable(const Tree& t, std::vector<float>& value, std::vector<char>& pruned, int node, int decision)
+{
+    std::vector<std::pair<int, float>> changed;
+    pruned[node] = 1;
+    for(int p = t.parent[node]; p >= 0; p = t.parent[p])
+    {
+        float points[6];
+        OwnMovePoints(t, t.children[p], value, pruned, points);
+        changed.push_back({p, value[p]});
+        value[p] = Best(points);
+    }
+
+    float root[6];
+    OwnMovePoints(t, t.rootChildren, value, pruned, root);
+    bool same = root[decision] > NOT_SEARCHED;
+    for(int m = 0; m < 6; m++)
+        if(root[m] > root[decision])
+            same = false;
+
+    pruned[node] = 0;
+    for(const auto& c : changed)
+        value[c.first] = c.second;
+    return same;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <search tree file> [number of expensive subtrees]" << std::endl;
+        return 1;
+    }
+    const int top = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    Tree t;
+    if(!agents::tree::Read(argv[1], t.header, t.nodes))
+    {
+        std::cerr << argv[1] << " is not a search tree" << std::endl;
+        return 1;
+    }
+
+    // post-order: the pending nodes of depth d+1 are the children of the next node of depth d
+    const int n = (int)t.nodes.size();
+    t.children.resize(n);
+    t.parent.assign(n, -1);
+    std::vector<std::vector<int>> pending(256);
+    int maxDepth = 0;
+    for(int i = 0; i < n; i++)
+    {
+        const int d = t.nodes[i].depth;
+        maxDepth = std::max(maxDepth, d);
+        t.children[i].swap(pending[d + 1]);
+        for(int c : t.children[i])
+            t.parent[c] = i;
+        pending[d].push_back(i);
+    }
+    t.rootChildren = pending[0];
+
+    std::cout << "Turn " << t.header.timeStep << ", agent " << t.header.agentId << ", move "
+              << t.header.chosenMove << ", depth " << t.header.maxDepth << " " << t.header.iterations[0] << " "
+              << t.header.iterations[1] << " " << t.header.iterations[2] << ", " << n << " nodes" << std::endl;
+
+    int mismatches;
+    std::vector<char> pruned(n, 0);
+    std::vector<float> value = Recompute(t, pruned, mismatches);
+    float root[6];
+    OwnMovePoints(t, t.rootChildren, value, pruned, root);
+    int decision = 0;
+    for(int m = 1; m < 6; m++)
+        if(root[m] > root[decision])
+            decision = m;
+    if(root[t.header.chosenMove] < root[decision])
+        std::cout << "The chosen move is not the best of the tree (kill solver, cancelled or forced turn)" << std::endl;
+    else
+        decision = t.header.chosenMove;
+    if(mismatches > 0)
+        std::cout << "Warning: " << mismatches << " inner nodes don't match their children" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2) << std::endl << "Root moves:";
+    for(int m = 0; m < 6; m++)
+        std::cout << "  " << m << ": " << root[m] << (m == decision ? "*" : "");
+    std::cout << std::endl;
+
+    // per depth
+    std::vector<int64_t> nodes(maxDepth + 1), inner(maxDepth + 1), timeCutoffs(maxDepth + 1);
+    std::vector<std::array<int64_t, 4>> legal(maxDepth + 1, {0, 0, 0, 0});
+    for(const Node& node : t.nodes)
+    {
+        nodes[node.depth]++;
+        if(node.flags & agents::tree::TIME_CUTOFF)
+            timeCutoffs[node.depth]++;
+        if(!(node.flags & agents::tree::LEAF))
+        {
+            inner[node.depth]++;
+            for(int a = 0; a < 4; a++)
+                legal[node.depth][a] += node.legalMoves[a];
+        }
+    }
+    std::cout << std::endl << std::setw(6) << "depth" << std::setw(10) << "nodes" << std::setw(10) << "EBF"
+              << std::setw(14) << "time cutoffs" << "   legal moves below (own teammate enemy1 enemy2)" << std::endl;
+    for(int d = 0; d <= maxDepth; d++)
+    {
+        const double parents = d == 0 ? 1.0 : (double)inner[d - 1];
+        std::cout << std::setw(6) << d << std::setw(10) << nodes[d] << std::setw(10)
+                  << (parents > 0 ? nodes[d] / parents : 0.0) << std::setw(14) << timeCutoffs[d] << "  ";
+        for(int a = 0; a < 4 && inner[d] > 0; a++)
+            std::cout << " " << legal[d][a] / (double)inner[d];
+        std::cout << std::endl;
+    }
+
+    // every subtree alone, the nested ones are counted at every depth
+    std::vector<int64_t> prunable(maxDepth + 1), prunableNodes(maxDepth + 1);
+    for(int i = 0; i < n; i++)
+    {
+        if(Prunable(t, value, pruned, i, decision))
+        {
+            prunable[t.nodes[i].depth]++;
+            prunableNodes[t.nodes[i].depth] += t.nodes[i].subtreeNodes;
+        }
+    }
+    std::cout << std::endl << "Subtrees which alone could have been pruned without changing the decision:" << std::endl;
+    for(int d = 0; d <= maxDepth; d++)
+    {
+        std::cout << std::setw(6) << d << std::setw(10) << prunable[d] << " of " << nodes[d] << " subtrees, "
+                  << prunableNodes[d] << " nodes" << std::endl;
+    }
+
+    // a root move is wasted effort if the decision is the same without it
+    std::cout << std::endl << "Root moves which could have been skipped:" << std::endl;
+    for(int m = 0; m < 6; m++)
+    {
+        if(m == decision || root[m] <= NOT_SEARCHED)
+            continue;
+        int64_t moveNodes = 0;
+        bool skippable = true;
+        for(int c : t.rootChildren)
+        {
+            if(t.nodes[c].moves[0] != m)
+                continue;
+            moveNodes += t.nodes[c].subtreeNodes;
+            pruned[c] = 1;
+        }
+        float points[6];
+        OwnMovePoints(t, t.rootChildren, value, pruned, points);
+        for(int o = 0; o < 6; o++)
+            skippable = skippable && points[o] <= points[decision];
+        for(int c : t.rootChildren)
+            pruned[c] = 0;
+        if(skippable)
+            std::cout << "  " << m << ": " << moveNodes << " nodes (" << 100.0 * moveNodes / n << "%), "
+                      << root[decision] - root[m] << " points below the decision" << std::endl;
+    }
+
+    // the most expensive subtrees of the first two depths
+    std::vector<int> expensive;
+    for(int i = 0; i < n; i++)
+        if(t.nodes[i].depth <= 1)
+            expensive.push_back(i);
+    std::sort(expensive.begin(), expensive.end(), [&](int a, int b)
+    {
+        return t.nodes[a].subtreeNodes > t.nodes[b].subtreeNodes;
+    });
+    expensive.resize(std::min<size_t>(expensive.size(), std::max(0, top)));
+    std::cout << std::endl << "Most expensive subtrees (moves: own teammate enemy1 enemy2):" << std::endl;
+    for(int i : expensive)
+    {
+        std::vector<int> path;
+        for(int p = i; p >= 0; p = t.parent[p])
+            path.insert(path.begin(), p);
+        std::cout << " ";
+        for(int p : path)
+        {
+            const Node& node = t.nodes[p];
+            std::cout << " " << (int)node.moves[0] << " " << (int)node.moves[1] << " " << (int)node.moves[2]
+                      << " " << (int)node.moves[3] << " |";
+        }
+        std::cout << " nodes: " << t.nodes[i].subtreeNodes << ", rollout ticks: " << t.nodes[i].rolloutTicks
+                  << ", value: " << t.nodes[i].value << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "decision_log.hpp"
+
+/**
+ * Prints a binary decision log (written when POMMERMAN_DECISION_LOG
+ * is set) as the text the agents print without it.
+ *
+ * Usage: decode_decision_log <file>
+ */
+int main(int argc, char** argv)
+{
+    if(argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <decision log file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if(!in)
+    {
+        std::cerr << "Couldn't open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    char magic[sizeof(bboard::log::FILE_MAGIC)];
+    if(!in.read(magic, sizeof(magic)) || std::memcmp(magic, bboard::log::FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        std::cerr << argv[1] << " is not a decision log" << std::endl;
+        return 1;
+    }
+
+    bboard::log::Record r;
+    while(in.read(reinterpret_cast<char*>(&r), sizeof(r)))
+    {
+        bboard::log::Format(r, std::cout);
+    }
+    if(in.gcount() != 0)
+    {
+        std::cerr << "Truncated record at the end of the file" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,472 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bboard.hpp"
+
+using namespace bboard;
+
+/**
+ * Differential fuzzer of the engine. A case is a seed: it sets up a board
+ * (kicks, more and stronger bombs, the agents in a square for ouroboros
+ * moves), plays random joint moves with Step for some steps, and then
+ * applies one more operation twice: with the reference implementation and
+ * with an alternative (a variant) of it. The two results have to be the
+ * same State, and the reference has to keep the State consistent.
+ *
+ * A failing case is minimized (the fewest random steps before it and the
+ * fewest setup features) and printed with the command which reproduces it.
+ *
+ * Step doesn't move an ouroboros onto a bomb correctly yet (see step.cpp),
+ * so the square is only fuzzed when it's asked for (--features 15).
+ *
+ * Usage: fuzz_step [--variant name] [--threads n] [--seconds s]
+ *                  [--cases n] [--seed first] [--features mask]
+ *        fuzz_step --variant name --seed s --steps k [--features f]
+ *                  (reproduces one case and prints the states)
+ */
+
+///////////
+// Cases //
+///////////
+
+enum Feature
+{
+    F_KICK     = 1,  // every agent can kick
+    F_BOMBS    = 2,  // every agent has 3 bombs
+    F_STRENGTH = 4,  // and a blast strength of 3
+    F_SQUARE   = 8,  // the agents start in a square in the middle
+    ALL_FEATURES = 15,
+    // without the square, until step.cpp handles an ouroboros onto a bomb
+    DEFAULT_FEATURES = F_KICK | F_BOMBS | F_STRENGTH
+};
+
+const int MAX_STEPS = 80;
+
+/**
+ * @brief Moves The random joint move of a step of a case. Depends only
+ * on the seed, the step and the state, so that shorter cases see the same
+ * moves. Like the search, Step only gets bombs which can be planted.
+ */
+void Moves(uint64_t seed, int step, const State& state, Move moves[AGENT_COUNT])
+{
+    std::mt19937_64 rng(seed * 0x9E3779B97F4A7C15ULL + step);
+    // bombs are planted more often than the other moves, there is more to explode
+    std::uniform_int_distribution<int> move(0, 7);
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const int m = move(rng);
+        moves[i] = Move(m > 5 ? (int)Move::BOMB : m);
+        const AgentInfo& a = state.agents[i];
+        if(moves[i] == Move::BOMB && (a.bombCount >= a.maxBombCount || state.HasBomb(a.x, a.y)))
+            moves[i] = Move::IDLE;
+    }
+}
+
+int Features(uint64_t seed)
+{
+    return (int)(seed >> 3) & ALL_FEATURES;
+}
+
+int Steps(uint64_t seed)
+{
+    return (int)((seed * 0xBF58476D1CE4E5B9ULL) >> 40) % (MAX_STEPS + 1);
+}
+
+/**
+ * @brief MakeCase The state of the case before the step which is compared
+ */
+void MakeCase(uint64_t seed, int steps, int features, State& state)
+{
+    state = State();
+    InitBoardItems(state, (int)seed);
+    if(features & F_SQUARE)
+    {
+        const Position square[AGENT_COUNT] = {{5, 4}, {6, 4}, {6, 5}, {5, 5}};
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            state.PutItem(square[i].x, square[i].y, Item::PASSAGE);
+            state.PutAgent(square[i].x, square[i].y, i);
+        }
+    }
+    else
+    {
+        state.PutAgentsInCorners(0, 1, 2, 3);
+    }
+    for(AgentInfo& a : state.agents)
+    {
+        a.canKick = features & F_KICK;
+        a.maxBombCount = features & F_BOMBS ? 3 : 1;
+        a.bombStrength = features & F_STRENGTH ? 3 : BOMB_DEFAULT_STRENGTH;
+    }
+
+    Move moves[AGENT_COUNT];
+    for(int i = 0; i < steps && state.aliveAgents > 1; i++)
+    {
+        Moves(seed, i, state, moves);
+        Step(&state, moves);
+    }
+}
+
+//////////////
+// Variants //
+//////////////
+
+/**
+ * @brief Variant An alternative implementation of an engine operation
+ * and the reference it has to match
+ */
+struct Variant
+{
+    const char* name;
+    const char* description;
+    void (*reference)(State& state, Move moves[AGENT_COUNT]);
+    void (*candidate)(State& state, Move moves[AGENT_COUNT]);
+};
+
+void ReferenceStep(State& state, Move moves[AGENT_COUNT])
+{
+    Step(&state, moves);
+}
+
+// Alternative implementations of Step belong here, with the reference
+// Step: {"step/<name>", "...", ReferenceStep, NewStep}
+// (TickAndMoveBombs10 of OneCallExplosion isn't one: it skips the time in
+// which no bomb moves, ticks before it checks whether the match is decided
+// and can tick more than 10 times, an approximation no policy enables)
+const Variant VARIANTS[] =
+{
+    {"step", "Step against itself, it has to be deterministic and keep the State consistent", ReferenceStep, ReferenceStep},
+};
+
+/////////////////
+// Comparisons //
+/////////////////
+
+template<typename T, int N>
+bool SameQueue(const FixedQueue<T, N>& a, const FixedQueue<T, N>& b)
+{
+    if(a.count != b.count)
+        return false;
+    for(int i = 0; i < a.count; i++)
+    {
+        if(std::memcmp(&a[i], &b[i], sizeof(T)) != 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Difference The first difference of the states (the contents of
+ * the queues, not where they start), empty if they are the same
+ */
+std::string Difference(const State& a, const State& b)
+{
+    std::ostringstream out;
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            if(a.board[y][x] != b.board[y][x])
+            {
+                out << "board (" << x << ", " << y << "): " << a.board[y][x] << " != " << b.board[y][x];
+                return out.str();
+            }
+        }
+    }
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& p = a.agents[i];
+        const AgentInfo& q = b.agents[i];
+        if(p.x != q.x || p.y != q.y || p.dead != q.dead || p.bombCount != q.bombCount || p.maxBombCount != q.maxBombCount
+                || p.bombStrength != q.bombStrength || p.canKick != q.canKick || (p.dead && p.diedAt != q.diedAt))
+        {
+            out << "agent " << i << ": (" << p.x << ", " << p.y << ") dead " << p.dead << " at " << p.diedAt << " bombs "
+                << p.bombCount << "/" << p.maxBombCount << " != (" << q.x << ", " << q.y << ") dead " << q.dead << " at "
+                << q.diedAt << " bombs " << q.bombCount << "/" << q.maxBombCount;
+            return out.str();
+        }
+    }
+    if(a.aliveAgents != b.aliveAgents)
+        return "aliveAgents " + std::to_string(a.aliveAgents) + " != " + std::to_string(b.aliveAgents);
+    if(a.relTimeStep != b.relTimeStep)
+        return "relTimeStep " + std::to_string(a.relTimeStep) + " != " + std::to_string(b.relTimeStep);
+    if(!SameQueue(a.bombs, b.bombs))
+        return "bombs " + std::to_string(a.bombs.count) + " != " + std::to_string(b.bombs.count) + " or differ";
+    if(!SameQueue(a.flames, b.flames))
+        return "flames " + std::to_string(a.flames.count) + " != " + std::to_string(b.flames.count) + " or differ";
+    if(!SameQueue(a.powerup_incr, b.powerup_incr) || !SameQueue(a.powerup_kick, b.powerup_kick)
+            || !SameQueue(a.powerup_extrabomb, b.powerup_extrabomb) || !SameQueue(a.woods, b.woods))
+        return "powerup or wood queues differ";
+    return "";
+}
+
+/**
+ * @brief Inconsistency What doesn't fit together in the state, empty if
+ * it is consistent
+ */
+std::string Inconsistency(const State& s)
+{
+    std::ostringstream out;
+    int alive = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& a = s.agents[i];
+        alive += !a.dead;
+        if(!a.dead && s.board[a.y][a.x] != Item::AGENT0 + i)
+        {
+            out << "agent " << i << " isn't on the board at (" << a.x << ", " << a.y << ")";
+            return out.str();
+        }
+        int bombs = 0;
+        for(int b = 0; b < s.bombs.count; b++)
+            bombs += BMB_ID(s.bombs[b]) == i;
+        // the bombs of the dead don't matter any more
+        if(!a.dead && bombs != a.bombCount)
+        {
+            out << "agent " << i << " has " << a.bombCount << " bombs, " << bombs << " are in the queue";
+            return out.str();
+        }
+    }
+    if(alive != s.aliveAgents)
+        return "aliveAgents " + std::to_string(s.aliveAgents) + ", " + std::to_string(alive) + " are alive";
+    for(int b = 0; b < s.bombs.count; b++)
+    {
+        const int item = s.board[BMB_POS_Y(s.bombs[b])][BMB_POS_X(s.bombs[b])];
+        if(item != Item::BOMB && !IS_AGENT(item))
+        {
+            out << "bomb at (" << BMB_POS_X(s.bombs[b]) << ", " << BMB_POS_Y(s.bombs[b]) << ") on item " << item;
+            return out.str();
+        }
+        if(b > 0 && BMB_TIME(s.bombs[b]) < BMB_TIME(s.bombs[b - 1]))
+            return "the bombs aren't sorted by their time";
+    }
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            if(s.board[y][x] == Item::BOMB && !s.HasBomb(x, y))
+            {
+                out << "bomb item at (" << x << ", " << y << ") without a bomb";
+                return out.str();
+            }
+        }
+    }
+    return "";
+}
+
+/**
+ * @brief Check Runs the case, the reason why it fails or an empty string
+ */
+std::string Check(const Variant& v, uint64_t seed, int steps, int features, State* before = nullptr,
+                  State* expected = nullptr, State* actual = nullptr)
+{
+    State start, ref, alt;
+    MakeCase(seed, steps, features, start);
+    Move moves[AGENT_COUNT];
+    Moves(seed, steps, start, moves);
+    ref = start;
+    alt = start;
+    v.reference(ref, moves);
+    v.candidate(alt, moves);
+    if(before)
+    {
+        *before = start;
+        *expected = ref;
+        *actual = alt;
+    }
+
+    const std::string consistency = Inconsistency(ref);
+    if(!consistency.empty())
+        return "the reference made an inconsistent state: " + consistency;
+    return Difference(ref, alt);
+}
+
+struct Failure
+{
+    uint64_t seed;
+    int steps;
+    int features;
+    std::string reason;
+};
+
+/**
+ * @brief Minimize The fewest steps and features with which the case still
+ * fails
+ */
+Failure Minimize(const Variant& v, uint64_t seed, int features)
+{
+    Failure f {seed, Steps(seed), features, ""};
+    for(int k = 0; k < f.steps; k++)
+    {
+        if(!Check(v, seed, k, f.features).empty())
+        {
+            f.steps = k;
+            break;
+        }
+    }
+    for(int bit = 1; bit <= ALL_FEATURES; bit <<= 1)
+    {
+        if((f.features & bit) && !Check(v, seed, f.steps, f.features & ~bit).empty())
+            f.features &= ~bit;
+    }
+    f.reason = Check(v, seed, f.steps, f.features);
+    return f;
+}
+
+const Variant* FindVariant(const std::string& name)
+{
+    for(const Variant& v : VARIANTS)
+    {
+        if(name == v.name)
+            return &v;
+    }
+    return nullptr;
+}
+
+int Reproduce(const Variant& v, uint64_t seed, int steps, int features)
+{
+    State before, expected, actual;
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    const std::string reason = Check(v, seed, steps, features, &before, &expected, &actual);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    Move moves[AGENT_COUNT];
+    Moves(seed, steps, before, moves);
+    std::cout << "Before, the moves are " << (int)moves[0] << " " << (int)moves[1] << " " << (int)moves[2] << " "
+              << (int)moves[3] << ":" << std::endl;
+    PrintState(&before);
+    std::cout << "Reference:" << std::endl;
+    PrintState(&expected);
+    std::cout << v.name << ":" << std::endl;
+    PrintState(&actual);
+    std::cout << (reason.empty() ? "Same" : reason) << std::endl;
+    return reason.empty() ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    std::string variantName;
+    int threads = (int)std::thread::hardware_concurrency();
+    double seconds = 10.0;
+    uint64_t cases = 0, firstSeed = 1;
+    int steps = -1, features = -1;
+    for(int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        if(arg == "--variant")
+            variantName = argv[i + 1];
+        else if(arg == "--threads")
+            threads = std::max(1, std::atoi(argv[i + 1]));
+        else if(arg == "--seconds")
+            seconds = std::atof(argv[i + 1]);
+        else if(arg == "--cases")
+            cases = std::strtoull(argv[i + 1], nullptr, 10);
+        else if(arg == "--seed")
+            firstSeed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if(arg == "--steps")
+            steps = std::atoi(argv[i + 1]);
+        else if(arg == "--features")
+            features = std::atoi(argv[i + 1]);
+        else
+        {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<const Variant*> variants;
+    for(const Variant& v : VARIANTS)
+    {
+        if(variantName.empty() || variantName == v.name)
+            variants.push_back(&v);
+    }
+    if(variants.empty())
+    {
+        std::cerr << "No variant " << variantName << ", there are:" << std::endl;
+        for(const Variant& v : VARIANTS)
+            std::cerr << "  " << v.name << ": " << v.description << std::endl;
+        return 1;
+    }
+
+    if(steps >= 0)
+    {
+        if(variants.size() != 1)
+        {
+            std::cerr << "Reproducing a case needs --variant" << std::endl;
+            return 1;
+        }
+        return Reproduce(*variants[0], firstSeed, steps, features >= 0 ? features : Features(firstSeed));
+    }
+
+    // only the features of the mask, without --features the default ones
+    const int mask = features >= 0 ? features : DEFAULT_FEATURES;
+    // Step talks about the bombs which the agents can't place
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    int result = 0;
+    for(const Variant* v : variants)
+    {
+        std::atomic<uint64_t> next(firstSeed);
+        std::atomic<uint64_t> done(0);
+        std::atomic<bool> failed(false);
+        std::mutex mutex;
+        uint64_t failingSeed = 0;
+        const auto start = std::chrono::steady_clock::now();
+        const auto end = start + std::chrono::duration<double>(seconds);
+
+        auto work = [&]
+        {
+            while(!failed)
+            {
+                if(cases == 0 ? std::chrono::steady_clock::now() >= end : next >= firstSeed + cases)
+                    return;
+                // a few cases between the clock reads
+                for(int i = 0; i < 16 && !failed; i++)
+                {
+                    const uint64_t seed = next++;
+                    if(cases > 0 && seed >= firstSeed + cases)
+                        return;
+                    if(!Check(*v, seed, Steps(seed), Features(seed) & mask).empty())
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        // the lowest failing seed, the same in every run
+                        if(!failed || seed < failingSeed)
+                            failingSeed = seed;
+                        failed = true;
+                    }
+                    done++;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; t++)
+            workers.emplace_back(work);
+        for(std::thread& t : workers)
+            t.join();
+
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << v->name << ": " << done << " cases in " << elapsed << "s (" << (uint64_t)(done / elapsed)
+                  << "/s, " << threads << " threads)";
+        if(!failed)
+        {
+            std::cerr << ", no difference" << std::endl;
+            continue;
+        }
+        const Failure f = Minimize(*v, failingSeed, Features(failingSeed) & mask);
+        std::cerr << std::endl << "FAILED: " << f.reason << std::endl
+                  << "Reproduce with: " << argv[0] << " --variant " << v->name << " --seed " << f.seed << " --steps "
+                  << f.steps << " --features " << f.features << std::endl;
+        result = 1;
+    }
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    return result;
+}
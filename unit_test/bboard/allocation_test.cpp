@@ -0,0 +1,181 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include <execinfo.h>
+#include <unistd.h>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+/*
+ * The global operator new/delete of the test binary count the allocations
+ * of all threads between ArmAllocationCounter and DisarmAllocationCounter:
+ * the calling thread, the OpenMP threads of the search and the workers of
+ * the agent (kill solver, deadline timer, decision log). The make build of
+ * bin/test has no OpenMP, there the search runs on the calling thread. The
+ * CMake build has the test with OpenMP as well (allocation_test, ctest).
+ */
+namespace
+{
+
+std::atomic<bool> armed(false);
+std::atomic<int> allocations(0);
+// backtrace itself must not be counted
+thread_local bool tracing = false;
+
+// the call stacks of the first allocations
+const int MAX_SITES = 8;
+const int MAX_FRAMES = 24;
+void* sites[MAX_SITES][MAX_FRAMES];
+int siteFrames[MAX_SITES];
+
+void CountAllocation()
+{
+    if(!armed || tracing)
+        return;
+    const int i = allocations++;
+    if(i < MAX_SITES)
+    {
+        tracing = true;
+        siteFrames[i] = backtrace(sites[i], MAX_FRAMES);
+        tracing = false;
+    }
+}
+
+void* Allocate(std::size_t size)
+{
+    CountAllocation();
+    if(void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* AllocateAligned(std::size_t size, std::align_val_t align)
+{
+    CountAllocation();
+    const std::size_t a = static_cast<std::size_t>(align);
+    // aligned_alloc wants a multiple of the alignment
+    if(void* p = std::aligned_alloc(a, (size + a - 1) / a * a))
+        return p;
+    throw std::bad_alloc();
+}
+
+void ArmAllocationCounter()
+{
+    allocations = 0;
+    armed = true;
+}
+
+int DisarmAllocationCounter()
+{
+    armed = false;
+    return allocations;
+}
+
+/**
+ * @brief PrintAllocationSites Writes the call stacks of the counted
+ * allocations to stderr. The addresses of the test binary resolve with
+ * addr2line -Cfe bin/test <address>
+ */
+void PrintAllocationSites()
+{
+    const int n = allocations;
+    for(int i = 0; i < n && i < MAX_SITES; i++)
+    {
+        std::cerr << "allocation " << i + 1 << " of " << n << ":" << std::endl;
+        backtrace_symbols_fd(sites[i], siteFrames[i], STDERR_FILENO);
+    }
+}
+
+}
+
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return AllocateAligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return AllocateAligned(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+/**
+ * @brief CountActAllocations Plays a game of SimpleAgents and lets agent A
+ * decide every turn of agent 0 as it is in production (verbose, with the
+ * turn deadline). The first act is not counted, it starts the threads of
+ * the agent and the decision log.
+ * @return The most allocations of one act
+ */
+template<typename A>
+int CountActAllocations(long seed, int turns)
+{
+    agents::SimpleAgent simple[AGENT_COUNT];
+    std::array<Agent*, AGENT_COUNT> players;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        simple[i].rng.seed(seed * AGENT_COUNT + i);
+        players[i] = &simple[i];
+    }
+
+    Environment env;
+    env.MakeGame(players);
+    State& state = env.GetState();
+    InitBoardItems(state, seed);
+    state.PutAgentsInCorners(0, 1, 2, 3);
+    state.ourId = 0;
+    state.teammateId = 2;
+    state.enemy1Id = 1;
+    state.enemy2Id = 3;
+
+    std::unique_ptr<A> agent = std::make_unique<A>();
+    agent->id = 0;
+    int most = 0;
+    for(int t = 0; t <= turns && !env.IsDone() && !state.agents[0].dead; t++)
+    {
+        agent->start_time = std::chrono::high_resolution_clock::now();
+        if(t > 0)
+            ArmAllocationCounter();
+        agent->act(&state);
+        const int n = DisarmAllocationCounter();
+        if(t > 0 && n > most)
+        {
+            most = n;
+            std::cerr << "act of turn " << state.timeStep << " allocated " << n << " times" << std::endl;
+            PrintAllocationSites();
+        }
+        env.Step(false);
+    }
+    return most;
+}
+
+TEST_CASE("No Heap Allocations In act", "[allocation]")
+{
+    // the decisions would be printed, unless they are logged (only during this test)
+    struct LogToNull
+    {
+        const bool set = !std::getenv("POMMERMAN_DECISION_LOG");
+        LogToNull() { if(set) setenv("POMMERMAN_DECISION_LOG", "/dev/null", 0); }
+        ~LogToNull() { if(set) unsetenv("POMMERMAN_DECISION_LOG"); }
+    } logToNull;
+    // resolves backtrace before anything is counted
+    void* frame[1];
+    backtrace(frame, 1);
+
+    SECTION("FrankfurtAgent")
+    {
+        REQUIRE(CountActAllocations<agents::FrankfurtAgent>(0x1337, 20) == 0);
+    }
+    SECTION("GottingenAgent")
+    {
+        REQUIRE(CountActAllocations<agents::GottingenAgent>(0x1337, 20) == 0);
+    }
+}
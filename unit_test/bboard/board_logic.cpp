@@ -467,6 +467,23 @@ TEST_CASE("Chained Explosions", "[step function]")
         REQUIRE(s->bombs.count == 0);
         REQUIRE(s->flames.count == 2);
     }
+    SECTION("Chained Bomb Before In The Queue")
+    {
+        // the later bomb explodes first (e.g. kicked into flames) and chains the earlier one
+        s->PutAgentsInCorners(0, 1, 2, 3);
+        s->PlantBomb(5, 5, 0, true);
+        s->PlantBomb(6, 5, 1, true);
+        s->PlantBomb(2, 8, 2, true);
+        s->ExplodeBombAt(1);
+
+        REQUIRE(s->bombs.count == 1);
+        REQUIRE(BMB_POS_X(s->bombs[0]) == 2);
+        REQUIRE(BMB_POS_Y(s->bombs[0]) == 8);
+        REQUIRE(s->board[8][2] == bboard::Item::BOMB);
+        REQUIRE(s->agents[0].bombCount == 0);
+        REQUIRE(s->agents[1].bombCount == 0);
+        REQUIRE(s->agents[2].bombCount == 1);
+    }
 
 
 }
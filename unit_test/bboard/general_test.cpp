@@ -1,4 +1,5 @@
 #include <iostream>
+#include <memory>
 
 #include "catch.hpp"
 #include "bboard.hpp"
@@ -59,3 +60,49 @@ TEST_CASE("Fixed Size Queue", "[general]")
 
 
 }
+
+/**
+ * @brief FixedAgent Always does the same move
+ */
+struct FixedAgent : Agent
+{
+    Move move = Move::IDLE;
+    Move act(const State*) override { return move; }
+};
+
+/**
+ * @brief PoisonStack Leaves bombs everywhere on the stack below the caller,
+ * where the next call keeps its uninitialized locals
+ */
+__attribute__((noinline)) void PoisonStack()
+{
+    volatile int garbage[1024];
+    for(int i = 0; i < 1024; i++)
+        garbage[i] = int(Move::BOMB);
+}
+
+TEST_CASE("Dead Agents Stay Idle", "[general]")
+{
+    FixedAgent a[AGENT_COUNT];
+    a[0].move = Move::DOWN;
+    a[3].move = Move::UP;
+    Environment env;
+    env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+    State& state = env.GetState();
+    state.Kill(1, 2);
+
+    // the same step, with idle moves of the dead agents
+    auto expected = std::make_unique<State>(state);
+    Move m[AGENT_COUNT] = {Move::DOWN, Move::IDLE, Move::IDLE, Move::UP};
+    Step(expected.get(), m);
+
+    PoisonStack();
+    env.Step(false);
+
+    REQUIRE(state.bombs.count == expected->bombs.count);
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        REQUIRE(state.agents[i].x == expected->agents[i].x);
+        REQUIRE(state.agents[i].y == expected->agents[i].y);
+    }
+}
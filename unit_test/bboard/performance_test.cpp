@@ -11,6 +11,8 @@
 #include "bboard.hpp"
 #include "agents.hpp"
 #include "colors.hpp"
+#include "step_profile.hpp"
+#include "hw_counters.hpp"
 
 using bboard::FixedQueue;
 
@@ -55,6 +57,8 @@ TEST_CASE("Step Function", "[performance]")
     int times = 1000;
     double t = -1;
     int totalSteps = 0;
+    bboard::profile::Reset();
+    bboard::perf::Sample hwCounters;
 
     for(int _ = 0; _ < 10; _++)
     {
@@ -63,6 +67,7 @@ TEST_CASE("Step Function", "[performance]")
         env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
         if(!THREADING)
         {
+            bboard::perf::ScopedSample hwSample(&hwCounters);
             t += timeMethod(times, Proxy, env);
             totalSteps += env.GetState().timeStep; //update the amount
         }
@@ -108,5 +113,12 @@ TEST_CASE("Step Function", "[performance]")
               << type_name<decltype(b)>()
               << "\nTime: " << t/100.0 << "\n";
 
+    if(!THREADING)
+        bboard::perf::Report(std::cout, "Step", hwCounters, totalSteps * 10);
+
+#ifdef STEP_PROFILE
+    bboard::profile::Report(std::cout);
+#endif
+
     REQUIRE(1);
 }
@@ -0,0 +1,199 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+TEST_CASE("Deepest Search", "[search]")
+{
+    // the others are too far to be iterated, and the budget allows any depth
+    std::unique_ptr<State> s = std::make_unique<State>();
+    InitBoardItems(*s.get(), 0x1337);
+    s->PutAgentsInCorners(0, 1, 2, 3);
+    s->ourId = 0;
+    s->teammateId = 2;
+    s->enemy1Id = 1;
+    s->enemy2Id = 3;
+
+    agents::GottingenAgent agent;
+    agent.id = 0;
+    agent.verbose = false;
+    agent.useKillSolver = false;
+    agent.depthController.stepsPerMs = 1e9f;
+    agent.start_time = std::chrono::high_resolution_clock::now();
+    agent.act(s.get());
+
+    // (copies, REQUIRE takes references)
+    const int maxDepth = agents::DepthController::maxDepth;
+    const int maxPly = agents::PVTable::MAX_PLY;
+    REQUIRE(agent.myMaxDepth == maxDepth);
+    // the first lines reach the leaves before the time levels cut the search
+    REQUIRE(agent.stats.nodes[maxDepth - 1] > 0);
+    REQUIRE(agent.principalVariation.count <= maxPly);
+}
+
+TEST_CASE("Adaptive Depth", "[search]")
+{
+    // without the calibration the agent searches the fixed depth of the turn
+    const float calibrated = agents::GottingenAgent::calibratedStepsPerMs;
+    agents::GottingenAgent::calibratedStepsPerMs = 0.0f;
+
+    for(int i = 0; i < agents::GottingenAgent::calibrationPositions; i++)
+    {
+        std::unique_ptr<State> s = std::make_unique<State>();
+        agents::GottingenAgent::CalibrationPosition(i, *s.get());
+        agents::GottingenAgent agent;
+        agent.id = 0;
+        agent.verbose = false;
+        agent.useKillSolver = false;
+        agent.timeLimit = false;
+        agent.start_time = std::chrono::high_resolution_clock::now();
+        agent.act(s.get());
+        const int fixedDepth = agent.myMaxDepth;
+        int t = agent.teammateIteration, e1 = agent.enemyIteration1, e2 = agent.enemyIteration2;
+
+        // a machine on which the fixed depth just fits the target, with the tree size of the search
+        agents::DepthController controller;
+        controller.stepsPerMs = 1.01f * agent.simulatedSteps / agents::DepthController::targetMillis;
+        controller.fill = agent.simulatedSteps / agents::DepthController::Estimate(fixedDepth, t, e1, e2);
+        int depth = fixedDepth;
+        controller.Choose(depth, t, e1, e2);
+
+        REQUIRE(depth >= fixedDepth);
+        REQUIRE(t == agent.teammateIteration);
+        REQUIRE(e1 == agent.enemyIteration1);
+        REQUIRE(e2 == agent.enemyIteration2);
+    }
+
+    agents::GottingenAgent::calibratedStepsPerMs = calibrated;
+}
+
+TEST_CASE("Depth Controller Feedback", "[search]")
+{
+    agents::DepthController controller;
+    controller.stepsPerMs = 100.0f;
+
+    SECTION("Fits The Tree Size")
+    {
+        const float estimate = agents::DepthController::Estimate(4, 1, 1, 0);
+        for(int i = 0; i < 50; i++)
+            controller.Record((int)(0.05f * estimate), 50.0f, 60.0f, true, 4, 1, 1, 0);
+        REQUIRE(controller.fill == Approx(0.05f).epsilon(0.01));
+    }
+    SECTION("Cut Searches Don't Count")
+    {
+        controller.Record(10, 50.0f, 60.0f, false, 4, 1, 1, 0);
+        REQUIRE(controller.fill == 1.0f);
+    }
+    SECTION("One Slow Turn In A Hundred")
+    {
+        // the budget grows while the turns are fast, and settles around 1% slow turns
+        for(int i = 0; i < 100; i++)
+            controller.Record(5000, 50.0f, 60.0f, true, 4, 1, 1, 0);
+        REQUIRE(controller.safety > 1.0f);
+        const float fast = controller.safety;
+        for(int i = 0; i < 99; i++)
+            controller.Record(5000, 50.0f, 60.0f, true, 4, 1, 1, 0);
+        controller.Record(5000, 50.0f, 120.0f, true, 4, 1, 1, 0);
+        REQUIRE(controller.safety == Approx(fast).epsilon(0.01));
+    }
+}
+
+TEST_CASE("Cancellable Search", "[search]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    agents::GottingenAgent::CalibrationPosition(0, *s.get());
+
+    auto decide = [&](bool cancellable)
+    {
+        auto agent = std::make_unique<agents::GottingenAgent>();
+        agent->id = 0;
+        agent->verbose = false;
+        agent->useKillSolver = false;
+        agent->timeLimit = false;
+        agent->start_time = std::chrono::high_resolution_clock::now();
+        const std::atomic<bool> never(false);
+        const Move m = cancellable ? agent->act(s.get(), &never, agent->start_time + std::chrono::hours(1))
+                                   : agent->act(s.get());
+        REQUIRE(agent->bestMoveSoFar == (int)m);
+        return m;
+    };
+
+    // a search that isn't cancelled gives the answer of the full search
+    REQUIRE(decide(true) == decide(false));
+}
+
+TEST_CASE("Cancelled Search", "[search]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    agents::GottingenAgent::CalibrationPosition(0, *s.get());
+
+    // the deepest search runs far longer than until the cancel
+    auto agent = std::make_unique<agents::GottingenAgent>();
+    agent->id = 0;
+    agent->verbose = false;
+    agent->useKillSolver = false;
+    agent->timeLimit = false;
+    agent->depthController.stepsPerMs = 1e9f;
+    agent->start_time = std::chrono::high_resolution_clock::now();
+
+    std::atomic<bool> token(false);
+    int duringSearch = -1;
+    std::chrono::high_resolution_clock::time_point cancelTime;
+    std::thread canceller([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        duringSearch = agent->bestMoveSoFar;
+        cancelTime = std::chrono::high_resolution_clock::now();
+        token = true;
+    });
+    const Move m = agent->act(s.get(), &token, agent->start_time + std::chrono::hours(1));
+    const auto returnTime = std::chrono::high_resolution_clock::now();
+    canceller.join();
+
+    REQUIRE(agent->stats.cutoffs[agents::SearchStats::CANCELLED] > 0);
+    // the search unwinds promptly
+    REQUIRE(std::chrono::duration<double, std::milli>(returnTime - cancelTime).count() < 10.0);
+    REQUIRE(agent->bestMoveSoFar == (int)m);
+    // the answer is the quick search's move or a root move whose subtree was searched completely
+    REQUIRE(agent->quickMove >= 0);
+    REQUIRE(((int)m == agent->quickMove || agent->rootCompleted[(int)m]));
+    REQUIRE(duringSearch >= 0);
+    REQUIRE((duringSearch == agent->quickMove || agent->rootCompleted[duringSearch]));
+}
+
+TEST_CASE("Concurrent Agents", "[search]")
+{
+    // two games at the same time (like game_benchmark --threads), every agent on its own thread
+    std::unique_ptr<State> s[2] = {std::make_unique<State>(), std::make_unique<State>()};
+    agents::GottingenAgent::CalibrationPosition(0, *s[0].get());
+    agents::GottingenAgent::CalibrationPosition(1, *s[1].get());
+
+    auto decide = [&](int i)
+    {
+        agents::GottingenAgent agent;
+        agent.id = 0;
+        agent.verbose = false;
+        agent.useKillSolver = false;
+        agent.timeLimit = false;
+        agent.rootThreads = 1;
+        agent.start_time = std::chrono::high_resolution_clock::now();
+        const Move m = agent.act(s[i].get());
+        return std::make_pair(m, agent.simulatedSteps);
+    };
+
+    std::pair<Move, int> alone[2] = {decide(0), decide(1)};
+    std::pair<Move, int> together[2];
+    std::thread other([&]() { together[1] = decide(1); });
+    together[0] = decide(0);
+    other.join();
+
+    REQUIRE(together[0] == alone[0]);
+    REQUIRE(together[1] == alone[1]);
+}
@@ -107,3 +107,147 @@ TEST_CASE("Move Towards Methods", "[strategy]")
         REQUIRE(m2 == Move::DOWN);
     }
 }
+
+TEST_CASE("Escape Oracle", "[strategy]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->Kill(1, 2, 3);
+    bool safe[6];
+
+    SECTION("No Escape From Dead End")
+    {
+        s->PutAgent(0, 0, 0);
+        s->PutItem(2, 0, Item::RIGID);
+        s->PutItem(1, 1, Item::RIGID);
+        s->PutItem(0, 2, Item::RIGID);
+        s->agents[0].bombStrength = 2;
+        s->PlantBombModifiedLife(0, 0, 0, 2);
+
+        REQUIRE(strategy::SafeMoves(*s.get(), 0, safe) == 0);
+
+        Move m;
+        REQUIRE(!strategy::ForcedEscapeMove(*s.get(), 0, m));
+    }
+    SECTION("Forced Escape")
+    {
+        s->PutAgent(5, 5, 0);
+        s->PutItem(4, 5, Item::RIGID);
+        s->PutItem(6, 5, Item::RIGID);
+        s->PutItem(5, 6, Item::RIGID);
+        s->PlantBombModifiedLife(5, 5, 0, 2);
+
+        REQUIRE(strategy::SafeMoves(*s.get(), 0, safe) == 1);
+        REQUIRE(safe[int(Move::UP)]);
+        REQUIRE(!safe[int(Move::IDLE)]);
+
+        Move m;
+        REQUIRE(strategy::ForcedEscapeMove(*s.get(), 0, m));
+        REQUIRE(m == Move::UP);
+    }
+    SECTION("Bomb In Dead End")
+    {
+        s->PutAgent(0, 0, 0);
+        s->PutItem(2, 0, Item::RIGID);
+        s->PutItem(1, 1, Item::RIGID);
+        s->PutItem(0, 2, Item::RIGID);
+        s->agents[0].bombStrength = 2;
+
+        REQUIRE(strategy::SafeMoves(*s.get(), 0, safe) == 3);
+        REQUIRE(safe[int(Move::IDLE)]);
+        REQUIRE(safe[int(Move::RIGHT)]);
+        REQUIRE(safe[int(Move::DOWN)]);
+        REQUIRE(!safe[int(Move::BOMB)]);
+    }
+    SECTION("Wait For Flames To Expire")
+    {
+        s->PutAgent(5, 5, 0);
+        s->PutItem(4, 5, Item::RIGID);
+        s->PutItem(6, 5, Item::RIGID);
+        s->PutItem(5, 6, Item::RIGID);
+        s->PutItem(5, 4, Item::RIGID);
+        s->SpawnFlame(5, 2, 1, 1);
+
+        // boxed in, but nothing will ever reach us
+        REQUIRE(strategy::SafeMoves(*s.get(), 0, safe) == 1);
+        REQUIRE(safe[int(Move::IDLE)]);
+    }
+    SECTION("Kick Away The Bomb")
+    {
+        s->PutAgent(5, 5, 0);
+        s->PutItem(4, 5, Item::RIGID);
+        s->PutItem(6, 5, Item::RIGID);
+        s->PutItem(5, 6, Item::RIGID);
+        s->agents[0].canKick = true;
+        s->agents[0].bombStrength = 2;
+        s->PlantBombModifiedLife(5, 4, 0, 3, true);
+
+        // staying burns, the kick is the only escape
+        REQUIRE(strategy::SafeMoves(*s.get(), 0, safe) == 1);
+        REQUIRE(safe[int(Move::UP)]);
+        REQUIRE(!safe[int(Move::IDLE)]);
+
+        // the search simulates the kick
+        Move m;
+        REQUIRE(!strategy::ForcedEscapeMove(*s.get(), 0, m));
+
+        // the kicked bomb explodes out of range
+        State kicked(*s.get());
+        Move moves[4] = {Move::UP, Move::IDLE, Move::IDLE, Move::IDLE};
+        for(int i = 0; i < 3; i++)
+        {
+            bboard::Step(&kicked, moves);
+            moves[0] = Move::IDLE;
+        }
+        REQUIRE(kicked.bombs.count == 0);
+        REQUIRE(!kicked.agents[0].dead);
+    }
+}
+
+TEST_CASE("Kill Solver", "[strategy]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->Kill(2, 3);
+    int nodes = 0;
+    Move m = Move::IDLE;
+
+    SECTION("Trap In Dead End")
+    {
+        // the enemy's only way out leads through us
+        s->PutAgent(1, 0, 0);
+        s->PutAgent(0, 0, 1);
+        s->PutItem(0, 1, Item::RIGID);
+        s->PutItem(1, 1, Item::RIGID);
+        s->agents[0].bombStrength = 2;
+
+        REQUIRE(strategy::ProveKill(*s.get(), 0, 1, 3, m, nullptr, nodes, 10000) == 1);
+        REQUIRE(m == Move::BOMB);
+    }
+    SECTION("Open Board")
+    {
+        s->PutAgent(5, 5, 0);
+        s->PutAgent(7, 5, 1);
+
+        REQUIRE(strategy::ProveKill(*s.get(), 0, 1, 2, m, nullptr, nodes, 10000) == 0);
+        REQUIRE(nodes > 0);
+    }
+    SECTION("Stop Flag")
+    {
+        s->PutAgent(5, 5, 0);
+        s->PutAgent(7, 5, 1);
+        std::atomic<bool> stop(true);
+
+        REQUIRE(strategy::ProveKill(*s.get(), 0, 1, 4, m, &stop, nodes, 10000) == 0);
+        REQUIRE(nodes == 1);
+    }
+    SECTION("Node Budget")
+    {
+        s->PutAgent(5, 5, 0);
+        s->PutAgent(7, 5, 1);
+        std::atomic<bool> stop(false);
+
+        // too deep to finish, the search gives up at the node after the budget
+        REQUIRE(strategy::ProveKill(*s.get(), 0, 1, 20, m, &stop, nodes, 10000) == 0);
+        REQUIRE(nodes == 10001);
+        REQUIRE(!stop);
+    }
+}